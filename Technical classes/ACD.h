@@ -2,16 +2,34 @@
 #include <vector>
 
 #include "Technical classes/chord_diagram_base_class.h"
+#include "Technical classes/static_vector.h"
+#include "Technical classes/ACD_in_place.h"
 
 /*
- This class represents annotated chord diagrams (ACD).
- It contains implementations of virtual functions from the base class, as well as a function for output.
+ This class represents annotated chord diagrams (ACD) with at most max_length chords.
+ It contains implementations of the functions described in the base class, as well as a function for output.
 */
 
-class ACD : public chord_diagram_base {
+template<int max_length>
+class ACD : public chord_diagram_base<linear_function<2 * max_length + 2>> {
+public:
+	using function_type = linear_function<2 * max_length + 2>;
+	using turns_type = static_vector<int, 2 * max_length>;
+	using in_place_type = ACD_in_place<max_length>;	// The same diagrams with transformations applied in place. It is used by the brute force functions.
+
+	static constexpr bool is_pre_ACD = false;
+
+	static const char* get_class_name() noexcept {
+		return "ACD";
+	}
+
 private:
-	std::vector<int> chords;
-	std::vector<linear_function> weights;
+	using base = chord_diagram_base<function_type>;
+	using base::total_increaser;
+	using base::number_of_increases;
+
+	static_vector<int, 2 * max_length> chords;
+	static_vector<function_type, 2 * max_length + 1> weights;
 
 public:
 	ACD() = default;
@@ -21,18 +39,18 @@ public:
 	ACD& operator=(const ACD&) = default;
 	ACD& operator=(ACD&&) = default;
 
-	ACD(const std::vector<int>& _chords) noexcept : chord_diagram_base(_chords.size() + 2){
+	ACD(const std::vector<int>& _chords) noexcept : base(_chords.size() + 2){
 		int counter = 0;
 		for (const auto& elt : _chords) {
-			chords.insert(chords.end(), elt);
-			weights.insert(weights.end(), linear_function(++counter, 1, _chords.size() + 2));
+			chords.push_back(elt);
+			weights.push_back(function_type(++counter, 1, _chords.size() + 2));
 		}
-		weights.insert(weights.end(), linear_function(++counter, 1, _chords.size() + 2));
+		weights.push_back(function_type(++counter, 1, _chords.size() + 2));
 	}
 
 	//Return vector with all indices where we can apply Transformation II. 
-	std::vector<int> get_all_possible_turns() const noexcept override {
-		std::vector<int> results;
+	turns_type get_all_possible_turns() const noexcept {
+		turns_type results;
 		for (auto iter = std::next(chords.cbegin()); iter != chords.cend(); ++iter)
 			if (*iter == *std::next(iter, -1))
 				results.push_back(*iter);
@@ -42,12 +60,12 @@ public:
 	//Use Transformation I to eliminate the chord closest to the basepoint.
 	//If ACD is not empty, the chord can be eliminated on either the left or right side.
 	// is_limit_case indicates whether we consider the limit case, i.e. when m->inf (and thus adding one more crossing is insignificant)
-	bool eliminate_from_side(bool is_right, bool is_limit_case) noexcept override {
+	bool eliminate_from_side(bool is_right, bool is_limit_case) noexcept {
 		if (chords.empty())
 			return false;
 
 		++number_of_increases;
-		linear_function p;
+		function_type p;
 		int chord_name = -1;
 		if (!is_right) {
 			p = *weights.begin();
@@ -92,7 +110,7 @@ public:
 	}
 
 	//Use Transformation II to eliminate chord. 
-	bool eliminate_turn(int chord_name) noexcept override {
+	bool eliminate_turn(int chord_name) noexcept {
 		++number_of_increases;
 		auto iter_chords = chords.begin();
 		auto iter_weights = weights.begin();
@@ -108,6 +126,19 @@ public:
 		return true;
 	}
 
+	//Write the canonical encoding of the current state into key. 
+	void get_state_key(std::vector<int>& key) const {
+		std::vector<int> names;
+		key.clear();
+		key.push_back(number_of_increases);
+		key.push_back(static_cast<int>(chords.size()));
+		for (auto chord : chords)
+			key.push_back(base::get_canonical_name(names, chord));
+		for (const auto& weight : weights)
+			weight.append_coefficients(key);
+		total_increaser.append_coefficients(key);
+	}
+
 	friend std::ostream& operator<<(std::ostream& stream_out, const ACD& _old) {
 		auto iter_weights = _old.weights.cbegin();
 		auto iter_chords = _old.chords.cbegin();
@@ -0,0 +1,245 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "Technical classes/chord_diagram_base_class.h"
+#include "Technical classes/static_vector.h"
+
+/*
+ This class represents the same annotated chord diagrams as ACD, but the transformations are applied in place and can be reverted by undo().
+ So the recursion in all_linear_functions_in_place uses one object for the whole tree of eliminations instead of a copy for every state.
+
+ The diagram is stored as a doubly linked list of nodes: the weights and the chord ends alternate, w[0] c[0] w[1] c[1] ... c[2n-1] w[2n].
+ The nodes are never moved, the eliminated ones are only unlinked (their own links are kept, so they can be linked back, see undo).
+ partner[] gives the other end of every chord, so no search is needed.
+ The weights are changed only by additions, so undo() subtracts the same functions, which are still stored in the unlinked nodes.
+ The results (the increaser and the state keys) coincide with the ones of ACD after the same transformations.
+*/
+
+template<int max_length>
+class ACD_in_place : public chord_diagram_base<linear_function<2 * max_length + 2>> {
+public:
+	using function_type = linear_function<2 * max_length + 2>;
+	using turns_type = static_vector<int, max_length>;	// The first ends of chords which can be eliminated by Transformation II.
+
+	static constexpr bool is_pre_ACD = false;
+
+	static const char* get_class_name() noexcept {
+		return "ACD";
+	}
+
+private:
+	using base = chord_diagram_base<function_type>;
+	using base::total_increaser;
+	using base::number_of_increases;
+
+	static constexpr int head = 0;							// The node before the first weight.
+	static constexpr int max_num_of_nodes = 4 * max_length + 3;
+
+	//Technical class. The record of the undo log, i.e. everything needed to revert one transformation.
+	class elimination_record {
+	public:
+		int removed[4];			// The unlinked nodes in order of unlinking.
+		int survivor;			// The weight which absorbs the weights around the eliminated chord.
+		int neighbour;			// For Transformation I, the weight next to the eliminated end of the diagram.
+		bool is_turn;
+		bool is_limit_case;
+	};
+
+	int tail;												// The node after the last weight.
+	int next[max_num_of_nodes];
+	int prev[max_num_of_nodes];
+	int name[max_num_of_nodes];								// The name of the chord (for the chord ends only).
+	int partner[max_num_of_nodes];							// The other end of the chord (for the chord ends only).
+	function_type weight[max_num_of_nodes];					// The weights (for the weights only).
+	int number_of_chord_ends;
+	static_vector<elimination_record, max_length> undo_log;
+
+private:
+	//Technical functions. Unlink the node from the list and link it back. Nodes must be linked back in the reverse order.
+	void unlink(int node) noexcept {
+		next[prev[node]] = next[node];
+		prev[next[node]] = prev[node];
+	}
+
+	void relink(int node) noexcept {
+		next[prev[node]] = node;
+		prev[next[node]] = node;
+	}
+
+public:
+	ACD_in_place(const std::vector<int>& _chords) noexcept : base(_chords.size() + 2), number_of_chord_ends(static_cast<int>(_chords.size())) {
+		int num_of_variables = static_cast<int>(_chords.size()) + 2;
+		tail = 2 * static_cast<int>(_chords.size()) + 2;
+		for (int node = head; node <= tail; ++node) {
+			next[node] = node + 1;
+			prev[node] = node - 1;
+		}
+		// The weight w[j] is the node 2j+1 and the chord end c[j] is the node 2j+2.
+		for (int j = 0; j <= static_cast<int>(_chords.size()); ++j)
+			weight[2 * j + 1] = function_type(j + 1, 1, num_of_variables);
+		int first_end[2 * max_length + 2];
+		std::fill_n(first_end, 2 * max_length + 2, -1);
+		for (int j = 0; j < static_cast<int>(_chords.size()); ++j) {
+			int node = 2 * j + 2;
+			name[node] = _chords[j];
+			if (first_end[_chords[j]] == -1)
+				first_end[_chords[j]] = node;
+			else {
+				partner[node] = first_end[_chords[j]];
+				partner[first_end[_chords[j]]] = node;
+			}
+		}
+	}
+
+	//Return the first ends of all chords where we can apply Transformation II, in the same order as ACD.
+	turns_type get_all_possible_turns() const noexcept {
+		turns_type results;
+		for (int node = next[next[head]]; node != tail; node = next[next[node]])
+			if (next[next[node]] == partner[node])
+				results.push_back(node);
+		return results;
+	}
+
+	//Use Transformation I to eliminate the chord closest to the basepoint, see ACD.
+	bool eliminate_from_side(bool is_right, bool is_limit_case) noexcept {
+		elimination_record record;
+		record.is_turn = false;
+		record.is_limit_case = is_limit_case;
+		int end_weight = is_right ? prev[tail] : next[head];
+		int chord = is_right ? prev[end_weight] : next[end_weight];
+		if (chord == head || chord == tail)
+			return false;
+		int other_end = partner[chord];
+		record.neighbour = is_right ? prev[chord] : next[chord];
+		record.survivor = is_right ? next[other_end] : prev[other_end];
+		int merged = is_right ? prev[other_end] : next[other_end];
+
+		++number_of_increases;
+		const function_type& p = weight[end_weight];
+		unlink(end_weight);
+		unlink(chord);
+		weight[record.neighbour] += p;
+		weight[record.survivor] += 2 * p + weight[merged];
+		if (!is_limit_case)
+			weight[record.survivor] += 1;
+		unlink(merged);
+		unlink(other_end);
+		total_increaser += 2 * p;
+		if (!is_limit_case)
+			total_increaser += 1;
+
+		record.removed[0] = end_weight;
+		record.removed[1] = chord;
+		record.removed[2] = merged;
+		record.removed[3] = other_end;
+		number_of_chord_ends -= 2;
+		undo_log.push_back(record);
+		return true;
+	}
+
+	//Use Transformation II to eliminate the chord with the given first end (see get_all_possible_turns).
+	bool eliminate_turn(int chord) noexcept {
+		elimination_record record;
+		record.is_turn = true;
+		record.is_limit_case = false;
+		int middle = next[chord];
+		int other_end = next[middle];
+		int after = next[other_end];
+		record.survivor = prev[chord];
+		record.neighbour = -1;
+
+		++number_of_increases;
+		total_increaser += weight[middle];
+		weight[record.survivor] += weight[middle] + weight[after];
+		unlink(chord);
+		unlink(middle);
+		unlink(other_end);
+		unlink(after);
+
+		record.removed[0] = chord;
+		record.removed[1] = middle;
+		record.removed[2] = other_end;
+		record.removed[3] = after;
+		number_of_chord_ends -= 2;
+		undo_log.push_back(record);
+		return true;
+	}
+
+	//Revert the last transformation.
+	void undo() noexcept {
+		const elimination_record& record = undo_log[undo_log.size() - 1];
+		if (record.is_turn) {
+			const function_type& middle = weight[record.removed[1]];
+			weight[record.survivor] -= middle + weight[record.removed[3]];
+			total_increaser -= middle;
+		}
+		else {
+			const function_type& p = weight[record.removed[0]];
+			total_increaser -= 2 * p;
+			if (!record.is_limit_case) {
+				total_increaser += -1;
+				weight[record.survivor] += -1;
+			}
+			weight[record.survivor] -= 2 * p + weight[record.removed[2]];
+			weight[record.neighbour] -= p;
+		}
+		for (int i = 3; i >= 0; --i)
+			relink(record.removed[i]);
+		--number_of_increases;
+		number_of_chord_ends += 2;
+		undo_log.pop_back();
+	}
+
+	//Write the canonical encoding of the current state into key. It coincides with the one of ACD.
+	void get_state_key(std::vector<int>& key) const {
+		int new_names[2 * max_length + 2];
+		std::fill_n(new_names, 2 * max_length + 2, -1);
+		int number_of_names = 0;
+		key.clear();
+		key.push_back(number_of_increases);
+		key.push_back(number_of_chord_ends);
+		for (int node = next[next[head]]; node != tail; node = next[next[node]]) {
+			if (new_names[name[node]] == -1)
+				new_names[name[node]] = number_of_names++;
+			key.push_back(new_names[name[node]]);
+		}
+		for (int node = next[head]; node != tail; node = next[node]) {
+			weight[node].append_coefficients(key);
+			if (next[node] != tail)
+				node = next[node];
+		}
+		total_increaser.append_coefficients(key);
+	}
+
+	//Write the canonical encoding of the residual diagram, i.e. of the current state without the linear functions, into key (see function_set_cache).
+	void get_residual_key(std::vector<int>& key) const {
+		int new_names[2 * max_length + 2];
+		std::fill_n(new_names, 2 * max_length + 2, -1);
+		int number_of_names = 0;
+		key.clear();
+		key.push_back(number_of_chord_ends);
+		for (int node = next[next[head]]; node != tail; node = next[next[node]]) {
+			if (new_names[name[node]] == -1)
+				new_names[name[node]] = number_of_names++;
+			key.push_back(new_names[name[node]]);
+		}
+	}
+
+	//Returns the number of weights left, i.e. the number of linear functions of the residual diagram.
+	int get_number_of_weights() const noexcept {
+		return number_of_chord_ends + 1;
+	}
+
+	//Exchange the weights (from the first one to the last one) and the increaser with the elements of weights.
+	//The size of weights is get_number_of_weights() + 1, and the increaser is the last element.
+	void swap_weights(std::vector<function_type>& weights) noexcept {
+		int i = 0;
+		for (int node = next[head]; ; node = next[next[node]]) {
+			std::swap(weight[node], weights[i++]);
+			if (next[node] == tail)
+				break;
+		}
+		std::swap(total_increaser, weights[i]);
+	}
+};
\ No newline at end of file
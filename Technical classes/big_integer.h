@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/*
+ This class is a signed integer of arbitrary size. It is used only by exact_lp_certificate, so it implements only what is needed there:
+ addition, subtraction, multiplication, division with a remainder, comparison and the conversion to long long.
+ The magnitude is stored as base 2^32 digits, the lowest digit first, without leading zeros (so 0 has no digits and is never negative).
+ The numbers there have a few hundred bits at most, so the schoolbook multiplication and the binary long division are enough.
+*/
+
+class big_integer {
+private:
+	bool is_negative;
+	std::vector<uint32_t> digits;
+
+private:
+	//Technical function. Remove the leading zeros.
+	void normalize() noexcept {
+		while (!digits.empty() && digits.back() == 0)
+			digits.pop_back();
+		if (digits.empty())
+			is_negative = false;
+	}
+
+	//Technical functions for the magnitudes.
+	static int compare_magnitudes(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) noexcept {
+		if (a.size() != b.size())
+			return a.size() < b.size() ? -1 : 1;
+		for (size_t i = a.size(); i-- > 0;)
+			if (a[i] != b[i])
+				return a[i] < b[i] ? -1 : 1;
+		return 0;
+	}
+
+	static std::vector<uint32_t> add_magnitudes(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+		std::vector<uint32_t> sum(std::max(a.size(), b.size()) + 1, 0);
+		uint64_t carry = 0;
+		for (size_t i = 0; i + 1 < sum.size(); ++i) {
+			carry += static_cast<uint64_t>(i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+			sum[i] = static_cast<uint32_t>(carry);
+			carry >>= 32;
+		}
+		sum.back() = static_cast<uint32_t>(carry);
+		return sum;
+	}
+
+	//a - b, where a is not less than b.
+	static std::vector<uint32_t> subtract_magnitudes(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+		std::vector<uint32_t> difference(a.size(), 0);
+		int64_t borrow = 0;
+		for (size_t i = 0; i < a.size(); ++i) {
+			int64_t current = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+			borrow = current < 0 ? 1 : 0;
+			difference[i] = static_cast<uint32_t>(current + (borrow << 32));
+		}
+		return difference;
+	}
+
+	//Technical function. The sum of the numbers with the given signs.
+	static big_integer add(const big_integer& a, bool a_is_negative, const big_integer& b, bool b_is_negative) {
+		big_integer sum;
+		if (a_is_negative == b_is_negative) {
+			sum.digits = add_magnitudes(a.digits, b.digits);
+			sum.is_negative = a_is_negative;
+		}
+		else if (compare_magnitudes(a.digits, b.digits) >= 0) {
+			sum.digits = subtract_magnitudes(a.digits, b.digits);
+			sum.is_negative = a_is_negative;
+		}
+		else {
+			sum.digits = subtract_magnitudes(b.digits, a.digits);
+			sum.is_negative = b_is_negative;
+		}
+		sum.normalize();
+		return sum;
+	}
+
+public:
+	big_integer(long long value = 0) : is_negative(value < 0) {
+		unsigned long long magnitude = is_negative ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+		for (; magnitude != 0; magnitude >>= 32)
+			digits.push_back(static_cast<uint32_t>(magnitude));
+	}
+
+	bool is_zero() const noexcept {
+		return digits.empty();
+	}
+
+	//Returns -1, 0 or 1.
+	int sign() const noexcept {
+		return is_zero() ? 0 : (is_negative ? -1 : 1);
+	}
+
+	big_integer operator-() const {
+		big_integer result = *this;
+		if (!result.is_zero())
+			result.is_negative = !result.is_negative;
+		return result;
+	}
+
+	friend big_integer operator+(const big_integer& a, const big_integer& b) {
+		return add(a, a.is_negative, b, b.is_negative);
+	}
+
+	friend big_integer operator-(const big_integer& a, const big_integer& b) {
+		return add(a, a.is_negative, b, !b.is_negative && !b.is_zero());
+	}
+
+	friend big_integer operator*(const big_integer& a, const big_integer& b) {
+		big_integer product;
+		if (a.is_zero() || b.is_zero())
+			return product;
+		product.digits.assign(a.digits.size() + b.digits.size(), 0);
+		for (size_t i = 0; i < a.digits.size(); ++i) {
+			uint64_t carry = 0;
+			for (size_t j = 0; j < b.digits.size(); ++j) {
+				carry += static_cast<uint64_t>(a.digits[i]) * b.digits[j] + product.digits[i + j];
+				product.digits[i + j] = static_cast<uint32_t>(carry);
+				carry >>= 32;
+			}
+			product.digits[i + b.digits.size()] = static_cast<uint32_t>(carry);
+		}
+		product.is_negative = a.is_negative != b.is_negative;
+		product.normalize();
+		return product;
+	}
+
+	//The division rounded toward zero, as for the built-in integers. The divisor should not be 0.
+	static void divide(const big_integer& a, const big_integer& b, big_integer& quotient, big_integer& remainder) {
+		quotient = big_integer();
+		remainder = big_integer();
+		quotient.digits.assign(a.digits.size(), 0);
+		for (size_t i = a.digits.size(); i-- > 0;)
+			for (int bit = 31; bit >= 0; --bit) {
+				// remainder = 2 * remainder + the next bit of a.
+				uint32_t carry = (a.digits[i] >> bit) & 1;
+				for (auto& digit : remainder.digits) {
+					uint32_t next_carry = digit >> 31;
+					digit = (digit << 1) | carry;
+					carry = next_carry;
+				}
+				if (carry != 0)
+					remainder.digits.push_back(carry);
+				if (compare_magnitudes(remainder.digits, b.digits) >= 0) {
+					remainder.digits = subtract_magnitudes(remainder.digits, b.digits);
+					remainder.normalize();
+					quotient.digits[i] |= 1u << bit;
+				}
+			}
+		quotient.is_negative = a.is_negative != b.is_negative;
+		quotient.normalize();
+		remainder.is_negative = a.is_negative;
+		remainder.normalize();
+	}
+
+	friend big_integer operator/(const big_integer& a, const big_integer& b) {
+		big_integer quotient, remainder;
+		divide(a, b, quotient, remainder);
+		return quotient;
+	}
+
+	friend big_integer operator%(const big_integer& a, const big_integer& b) {
+		big_integer quotient, remainder;
+		divide(a, b, quotient, remainder);
+		return remainder;
+	}
+
+	//The greatest common divisor of the absolute values.
+	static big_integer gcd(big_integer a, big_integer b) {
+		a.is_negative = b.is_negative = false;
+		while (!b.is_zero()) {
+			big_integer r = a % b;
+			a = std::move(b);
+			b = std::move(r);
+		}
+		return a;
+	}
+
+	friend bool operator==(const big_integer& a, const big_integer& b) noexcept {
+		return a.is_negative == b.is_negative && a.digits == b.digits;
+	}
+
+	friend bool operator<(const big_integer& a, const big_integer& b) noexcept {
+		if (a.is_negative != b.is_negative)
+			return a.is_negative;
+		int comparison = compare_magnitudes(a.digits, b.digits);
+		return a.is_negative ? comparison > 0 : comparison < 0;
+	}
+
+	friend bool operator!=(const big_integer& a, const big_integer& b) noexcept {
+		return !(a == b);
+	}
+
+	friend bool operator>(const big_integer& a, const big_integer& b) noexcept {
+		return b < a;
+	}
+
+	friend bool operator<=(const big_integer& a, const big_integer& b) noexcept {
+		return !(b < a);
+	}
+
+	friend bool operator>=(const big_integer& a, const big_integer& b) noexcept {
+		return !(a < b);
+	}
+
+	//Writes the number to value and returns true if its absolute value is not greater than max_value.
+	bool to_long_long(long long& value, long long max_value = std::numeric_limits<long long>::max()) const noexcept {
+		if (digits.size() > 2)
+			return false;
+		unsigned long long magnitude = 0;
+		for (size_t i = digits.size(); i-- > 0;)
+			magnitude = (magnitude << 32) | digits[i];
+		if (magnitude > static_cast<unsigned long long>(max_value))
+			return false;
+		value = is_negative ? -static_cast<long long>(magnitude) : static_cast<long long>(magnitude);
+		return true;
+	}
+};
\ No newline at end of file
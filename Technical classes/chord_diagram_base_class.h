@@ -1,32 +1,49 @@
 #pragma once
 #include <ostream>
+#include <vector>
+#include <algorithm>
 
 #include "Technical classes/linear_function_coefficients.h"
 
 /*
 This file contains base class for chord diagrams. It has two derived classes: ACD and preACD.
+The derived classes are templates on the maximal length (the number of chords), so all their storage has a fixed size.
+There are no virtual functions: the brute force functions are templates on the diagram type, so every call is resolved at compile time.
+Every derived class implements the following functions:
+	get_all_possible_turns()					returns all indices where we can apply Transformation II;
+	eliminate_from_side(is_right, is_limit_case)	uses Transformation I to eliminate the chord closest to the basepoint,
+												and returns false if there are no letters left on the corresponding side
+												(is_limit_case shows whether we consider the limit case, i.e. when m->inf);
+	eliminate_turn(index)						uses Transformation II to eliminate chord;
+	get_state_key(key)							writes the canonical encoding of the current state into key (two states with the same encoding 
+												give the same set of linear functions after the remaining eliminations).
+It also defines is_pre_ACD and get_class_name(), which are used instead of the run-time type information.
 */
 
+// The maximal length of diagrams. The classes are instantiated for every length from 1 to n_max, see length_dispatcher.
+constexpr int n_max = 12;
+
+template<class function_type>
 class chord_diagram_base {
 protected:
-	linear_function total_increaser;	// If some of the chords have been eliminated, the resulting linear function is stored here.
+	function_type total_increaser;	// If some of the chords have been eliminated, the resulting linear function is stored here.
 	int number_of_increases;			// The number of chords that have been eliminated.
 
-public:
-	explicit chord_diagram_base(int num_of_variables) : total_increaser(0, 0, num_of_variables), number_of_increases(0) {}
-
-	//Return vector with all indices where we can apply Transformation II. 
-	virtual std::vector<int> get_all_possible_turns() const noexcept = 0;
-
-	//Use Transformation I to eliminate the chord closest to the basepoint. 
-	//If the function returns false, then there are no letters left on the corresponding side.
-	// is_limit_case shows whether we consider the limit case, i.e. when m->inf (and thus adding one more crossing is insignificant)
-	virtual bool eliminate_from_side(bool is_right, bool is_limit_case) noexcept = 0;
+protected:
+	//Technical function. Chords are renamed in order of their first appearance, so that the encoding does not depend on their names.
+	static int get_canonical_name(std::vector<int>& names, int name) {
+		auto iter = std::find(names.begin(), names.end(), name);
+		if (iter != names.end())
+			return static_cast<int>(iter - names.begin());
+		names.push_back(name);
+		return static_cast<int>(names.size()) - 1;
+	}
 
-	//Use Transformation II to eliminate chord. 
-	virtual bool eliminate_turn(int index) noexcept = 0;
+public:
+	chord_diagram_base() noexcept : total_increaser(), number_of_increases(0) {}
+	explicit chord_diagram_base(int num_of_variables) noexcept : total_increaser(0, 0, num_of_variables), number_of_increases(0) {}
 
-	const linear_function& get_increaser() const noexcept {
+	const function_type& get_increaser() const noexcept {
 		return total_increaser;
 	}
 
@@ -0,0 +1,286 @@
+#pragma once
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ These classes write and read a corpus, i.e. a binary file with the vectors rhs_lhs of all interesting (pre)ACD of one length
+ in the order of walk_trough_all_diagrams (see export_diagram_corpus). The estimation then reads the diagrams from the file
+ instead of enumerating them (see corpus_prefix in estimation_options), and the file is a fixed workload for the comparison of versions.
+
+ The file consists of a header (see corpus_header), the index and the records. Every record is a diagram packed into bits_per_symbol bits
+ per symbol (the symbols are not greater than 2 * length), the first symbol in the lowest bits; the records are aligned to bytes,
+ so a record of length 12 takes 15 bytes. The index contains number_of_units + 1 numbers: the first record of every unit of collect_units
+ (with the same split_depth) and the number of records, so the units of the corpus are the same as those of the enumeration
+ and checkpoints and shards do not depend on where the diagrams come from.
+ The reader maps the whole file into memory, so the threads read their units without copying and without locks.
+*/
+
+//Technical class. The header of the corpus file.
+class corpus_header {
+public:
+	char magic[8];
+	int class_id;					// 0 for ACD and 1 for preACD.
+	int length;
+	int split_depth;
+	int number_of_units;
+	int bits_per_symbol;
+	int record_size;				// In bytes.
+	long long number_of_diagrams;
+
+	//Technical function. The first bytes of every corpus file.
+	static const char* get_corpus_magic() noexcept {
+		return "CR2CORP1";
+	}
+
+	corpus_header() noexcept : class_id(0), length(0), split_depth(0), number_of_units(0), bits_per_symbol(0), record_size(0), number_of_diagrams(0) {
+		std::memcpy(magic, get_corpus_magic(), sizeof(magic));
+	}
+
+	corpus_header(int _class_id, int _length, int _split_depth, int _number_of_units) noexcept : corpus_header() {
+		class_id = _class_id;
+		length = _length;
+		split_depth = _split_depth;
+		number_of_units = _number_of_units;
+		for (bits_per_symbol = 1; (2 * length) >> bits_per_symbol != 0; ++bits_per_symbol);
+		record_size = (2 * length * bits_per_symbol + 7) / 8;
+	}
+
+	//The offset of the first record in the file.
+	long long get_records_offset() const noexcept {
+		return static_cast<long long>(sizeof(corpus_header)) + static_cast<long long>(sizeof(long long)) * (number_of_units + 1);
+	}
+};
+
+// This class writes a corpus. The units should be started in increasing order, and the diagrams of every unit added after its start.
+class diagram_corpus_writer {
+private:
+	std::string file_name;
+	std::ofstream file_out;
+	corpus_header header;
+	std::vector<long long> index;
+	std::vector<unsigned char> buffer;
+
+	static constexpr size_t buffer_size = 1 << 20;		// The number of bytes written at once.
+
+private:
+	//Technical function. Write the buffer to the file.
+	void flush() {
+		file_out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		buffer.clear();
+	}
+
+public:
+	diagram_corpus_writer(const std::string& _file_name, int class_id, int length, int split_depth, int number_of_units) :
+		file_name(_file_name), file_out(_file_name + ".tmp", std::ios::binary | std::ios::trunc), header(class_id, length, split_depth, number_of_units) {
+		index.reserve(number_of_units + 1);
+		buffer.reserve(buffer_size + header.record_size);
+		// The header and the index are written again at the end, when they are known.
+		file_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		std::vector<long long> empty_index(number_of_units + 1, 0);
+		file_out.write(reinterpret_cast<const char*>(empty_index.data()), sizeof(long long) * empty_index.size());
+	}
+
+	diagram_corpus_writer(const diagram_corpus_writer&) = delete;
+	diagram_corpus_writer& operator=(const diagram_corpus_writer&) = delete;
+
+	long long get_number_of_diagrams() const noexcept {
+		return header.number_of_diagrams;
+	}
+
+	void start_unit() {
+		index.push_back(header.number_of_diagrams);
+	}
+
+	void add(const std::vector<int>& rhs_lhs) {
+		size_t start = buffer.size();
+		buffer.resize(start + header.record_size, 0);
+		unsigned long long bits = 0;
+		int number_of_bits = 0;
+		for (int symbol : rhs_lhs) {
+			bits |= static_cast<unsigned long long>(symbol) << number_of_bits;
+			for (number_of_bits += header.bits_per_symbol; number_of_bits >= 8; number_of_bits -= 8, bits >>= 8)
+				buffer[start++] = static_cast<unsigned char>(bits);
+		}
+		if (number_of_bits > 0)
+			buffer[start] = static_cast<unsigned char>(bits);
+		++header.number_of_diagrams;
+		if (buffer.size() >= buffer_size)
+			flush();
+	}
+
+	//Write the rest of the records and the index. The file is written under a temporary name and renamed only here,
+	//so an interrupted export does not leave an incomplete corpus. Returns false if the file cannot be written.
+	bool close() {
+		flush();
+		if (static_cast<int>(index.size()) != header.number_of_units)
+			return false;
+		index.push_back(header.number_of_diagrams);
+		file_out.seekp(0);
+		file_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file_out.write(reinterpret_cast<const char*>(index.data()), sizeof(long long) * index.size());
+		file_out.close();
+		if (!file_out)
+			return false;
+		std::remove(file_name.c_str());
+		return std::rename((file_name + ".tmp").c_str(), file_name.c_str()) == 0;
+	}
+};
+
+// This class reads a corpus mapped into memory.
+class diagram_corpus {
+private:
+	const unsigned char* data;
+	size_t size;
+	corpus_header header;
+	const long long* index;
+	const unsigned char* records;
+#ifdef _WIN32
+	HANDLE file_handle;
+	HANDLE mapping_handle;
+#endif
+
+private:
+	//Technical function. Unmap the file.
+	void close() noexcept {
+#ifdef _WIN32
+		if (data != nullptr)
+			UnmapViewOfFile(data);
+		if (mapping_handle != NULL)
+			CloseHandle(mapping_handle);
+		if (file_handle != INVALID_HANDLE_VALUE)
+			CloseHandle(file_handle);
+		mapping_handle = NULL;
+		file_handle = INVALID_HANDLE_VALUE;
+#else
+		if (data != nullptr)
+			munmap(const_cast<unsigned char*>(data), size);
+#endif
+		data = nullptr;
+		size = 0;
+	}
+
+	//Technical function. Map the whole file into memory. Returns false if it cannot be done.
+	bool map(const std::string& file_name) noexcept {
+#ifdef _WIN32
+		file_handle = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file_handle == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+			return false;
+		mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping_handle == NULL)
+			return false;
+		data = static_cast<const unsigned char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+		size = static_cast<size_t>(file_size.QuadPart);
+#else
+		int descriptor = ::open(file_name.c_str(), O_RDONLY);
+		if (descriptor < 0)
+			return false;
+		struct stat file_stat;
+		if (fstat(descriptor, &file_stat) != 0 || file_stat.st_size == 0) {
+			::close(descriptor);
+			return false;
+		}
+		void* address = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+		::close(descriptor);
+		if (address == MAP_FAILED)
+			return false;
+		data = static_cast<const unsigned char*>(address);
+		size = static_cast<size_t>(file_stat.st_size);
+#endif
+		return data != nullptr;
+	}
+
+public:
+	diagram_corpus() noexcept : data(nullptr), size(0), index(nullptr), records(nullptr) {
+#ifdef _WIN32
+		file_handle = INVALID_HANDLE_VALUE;
+		mapping_handle = NULL;
+#endif
+	}
+
+	diagram_corpus(const diagram_corpus&) = delete;
+	diagram_corpus& operator=(const diagram_corpus&) = delete;
+
+	~diagram_corpus() {
+		close();
+	}
+
+	//Map the file and check it. Returns false if there is no file, or it has a wrong format, or it belongs to another class or length.
+	bool open(const std::string& file_name, int class_id, int length) {
+		close();
+		if (!map(file_name) || size < sizeof(corpus_header)) {
+			close();
+			return false;
+		}
+		std::memcpy(&header, data, sizeof(header));
+		corpus_header expected(class_id, length, header.split_depth, header.number_of_units);
+		bool is_correct = std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 && header.class_id == class_id && header.length == length
+			&& header.number_of_units > 0 && header.bits_per_symbol == expected.bits_per_symbol && header.record_size == expected.record_size
+			&& header.number_of_diagrams >= 0 && static_cast<long long>(size) >= header.get_records_offset();
+		if (is_correct) {
+			index = reinterpret_cast<const long long*>(data + sizeof(corpus_header));
+			records = data + header.get_records_offset();
+			is_correct = index[header.number_of_units] == header.number_of_diagrams
+				&& static_cast<long long>(size) == header.get_records_offset() + header.number_of_diagrams * header.record_size;
+			for (int i = 0; is_correct && i < header.number_of_units; ++i)
+				is_correct = index[i] >= 0 && index[i] <= index[i + 1];
+		}
+		if (!is_correct)
+			close();
+		return is_correct;
+	}
+
+	bool is_open() const noexcept {
+		return data != nullptr;
+	}
+
+	int get_split_depth() const noexcept {
+		return header.split_depth;
+	}
+
+	int get_number_of_units() const noexcept {
+		return header.number_of_units;
+	}
+
+	long long get_number_of_diagrams() const noexcept {
+		return header.number_of_diagrams;
+	}
+
+	//The records of the unit are [get_unit_begin(unit), get_unit_begin(unit + 1)).
+	long long get_unit_begin(int unit) const noexcept {
+		return index[unit];
+	}
+
+	//Unpack the diagram with the given number into rhs_lhs (its size is 2 * length).
+	void get_diagram(long long number, std::vector<int>& rhs_lhs) const {
+		const unsigned char* record = records + number * header.record_size;
+		rhs_lhs.resize(2 * header.length);
+		unsigned long long bits = 0;
+		int number_of_bits = 0;
+		unsigned mask = (1u << header.bits_per_symbol) - 1;
+		for (int& symbol : rhs_lhs) {
+			for (; number_of_bits < header.bits_per_symbol; number_of_bits += 8)
+				bits |= static_cast<unsigned long long>(*record++) << number_of_bits;
+			symbol = static_cast<int>(bits & mask);
+			bits >>= header.bits_per_symbol;
+			number_of_bits -= header.bits_per_symbol;
+		}
+	}
+};
\ No newline at end of file
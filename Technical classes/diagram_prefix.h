@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+ This class represents the beginning of the vector rhs_lhs of a (pre)ACD during the enumeration (see walk_trough_all_diagrams).
+ Symbols are added and removed only at the end, and the class updates the data needed to extend and to check the prefix, so that
+ the result of not_interesting and the values of get_possible_values are obtained in O(1) without rescanning the prefix and without allocations:
+ the set of open chords (the symbols that have appeared an odd number of times) as a bitmask, the maximal symbol,
+ and the number of repeated symbols among the last length symbols.
+ Every prefix is checked as soon as its last symbol is added, so only the conditions involving the last symbol are checked.
+*/
+
+class diagram_prefix {
+public:
+	static constexpr int max_symbol = 31;		// The symbols are stored in a bitmask of 32 bits. For n_max = 12 they are not greater than 24.
+
+private:
+	int length;
+	bool is_pre_ACD;
+	std::vector<int> symbols;
+	std::vector<int> max_symbols;				// max_symbols[i] is the maximal symbol among the first i symbols (0 for the empty prefix).
+	unsigned open_chords;
+	int number_in_window[max_symbol + 1];		// The numbers of occurrences of the symbols among the last length symbols.
+	int number_of_repeats;						// The number of symbols among the last length symbols which have occurred there before.
+
+private:
+	//Technical functions. Add the symbol to the window of the last length symbols and remove it.
+	void add_to_window(int symbol) noexcept {
+		if (number_in_window[symbol]++ > 0)
+			++number_of_repeats;
+	}
+
+	void remove_from_window(int symbol) noexcept {
+		if (--number_in_window[symbol] > 0)
+			--number_of_repeats;
+	}
+
+public:
+	//Technical function. The index of the lowest set bit of a non-zero mask, e.g. of the smallest value of get_possible_values.
+	static int get_lowest_bit(unsigned mask) noexcept {
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanForward(&index, mask);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	diagram_prefix(int _length, bool _is_pre_ACD, const std::vector<int>& _symbols = std::vector<int>()) :
+		length(_length), is_pre_ACD(_is_pre_ACD), open_chords(0), number_of_repeats(0) {
+		symbols.reserve(2 * length);
+		max_symbols.reserve(2 * length + 1);
+		max_symbols.push_back(0);
+		for (int& number : number_in_window)
+			number = 0;
+		for (int symbol : _symbols)
+			push(symbol);
+	}
+
+	void push(int symbol) noexcept {
+		symbols.push_back(symbol);
+		max_symbols.push_back(std::max(max_symbols.back(), symbol));
+		open_chords ^= 1u << symbol;
+		add_to_window(symbol);
+		if (static_cast<int>(symbols.size()) > length)
+			remove_from_window(symbols[symbols.size() - 1 - length]);
+	}
+
+	void pop() noexcept {
+		if (static_cast<int>(symbols.size()) > length)
+			add_to_window(symbols[symbols.size() - 1 - length]);
+		remove_from_window(symbols.back());
+		open_chords ^= 1u << symbols.back();
+		max_symbols.pop_back();
+		symbols.pop_back();
+	}
+
+	//Returns the same result as not_interesting for the prefix, provided that the prefix without the last symbol is interesting.
+	bool is_not_interesting() const noexcept {
+		if (length < 4)
+			return false;
+		// A chord of length 1 ends with the last symbol.
+		int i = static_cast<int>(symbols.size()) - 1;
+		if (i >= 1 && symbols[i] == symbols[i - 1] && (!is_pre_ACD || i != length))
+			return true;
+		// All chords of the last length symbols are different.
+		return length > 5 && static_cast<int>(symbols.size()) >= length && number_of_repeats == 0;
+	}
+
+	//Returns the same set of values as get_possible_values as a bitmask: the value c is possible if the bit 1 << c is set.
+	//The values in increasing order are given by get_lowest_bit.
+	unsigned get_possible_values() const noexcept {
+		int max_v = symbols.empty() ? -1 : max_symbols.back();
+		unsigned values = open_chords;
+		if (max_v < length || is_pre_ACD)
+			values |= 1u << (max_v + 1);
+		return values;
+	}
+
+	const std::vector<int>& get_symbols() const noexcept {
+		return symbols;
+	}
+
+	int size() const noexcept {
+		return static_cast<int>(symbols.size());
+	}
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "Technical classes/function_set_cache.h"
+#include "Technical classes/linear_function_front.h"
+
+/*
+ This class lets several threads construct the set of linear functions of one diagram, so a single large tree of eliminations is not processed
+ by one thread while the others are idle (see all_linear_functions_shared). The thread that owns the diagram traverses the tree as usual, but when
+ some thread of the pool is idle, the states below a large state (with at least min_moves_to_share remaining eliminations) are shared:
+ all but the first transformations are applied to copies of the state, which are stored here, and the pool is asked for help
+ (call_helper adds a task, see walk_task). Any thread may take a stored state, expand it into its own front and merge the front here.
+ When the owner has finished its own part, it expands the remaining states itself without sharing them again, and it sleeps (see wait_and_take)
+ while the states taken by other threads are expanded.
+
+ The set of non-dominated functions does not depend on the order of insertions, so the result is the same as the one of a single thread.
+ Every thread has its own transposition table, so a state may be expanded by several threads, which only costs time.
+ The template parameter is the class with transformations applied in place (e.g. ACD_in_place), so a stored state is a plain copy.
+*/
+
+template<class chord_like_type>
+class elimination_job {
+public:
+	using function_type = typename chord_like_type::function_type;
+
+	int number_of_moves;
+	bool is_limit_case;
+	int min_moves_to_share;
+	function_set_cache* cache;
+	bool measure_stage_times;
+	std::function<bool()> is_hungry;		// Returns true if some thread of the pool is idle.
+	std::function<void()> call_helper;		// Adds a task to the pool which takes the stored states (see expand_shared_states).
+
+private:
+	std::mutex mutex;
+	std::vector<chord_like_type> waiting_states;			// The shared states that have not been taken yet.
+	linear_function_front<function_type> results;			// The merged functions of the states expanded by other threads.
+	std::atomic<int> number_of_waiting_states;
+	std::atomic<int> number_of_unfinished_states;			// The shared states that have not been expanded yet, including the waiting ones.
+	std::condition_variable state_changed;					// Notified when a state is shared or finished, see wait_and_take.
+
+public:
+	elimination_job(int _number_of_moves, bool _is_limit_case, int _min_moves_to_share, function_set_cache* _cache = nullptr,
+		bool _measure_stage_times = false) : number_of_moves(_number_of_moves), is_limit_case(_is_limit_case), min_moves_to_share(_min_moves_to_share),
+		cache(_cache), measure_stage_times(_measure_stage_times), number_of_waiting_states(0), number_of_unfinished_states(0) {}
+
+	elimination_job(const elimination_job&) = delete;
+	elimination_job& operator=(const elimination_job&) = delete;
+
+	//Returns true if the states below the given one should be shared, i.e. if some thread of the pool is idle.
+	//They are not shared until the states shared before are taken.
+	bool is_worth_sharing(const chord_like_type& state) const {
+		return number_of_moves - state.get_number_of_increases() >= min_moves_to_share && number_of_waiting_states.load(std::memory_order_relaxed) == 0
+			&& is_hungry();
+	}
+
+	//Store a copy of the state and ask the pool for help.
+	void share(const chord_like_type& state) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			waiting_states.push_back(state);
+			number_of_waiting_states.fetch_add(1);
+			number_of_unfinished_states.fetch_add(1);
+		}
+		state_changed.notify_all();
+		call_helper();
+	}
+
+	//Take a stored state, it becomes the only element of state (so the class needs no default constructor). Returns false if there are none.
+	bool take(std::vector<chord_like_type>& state) {
+		if (number_of_waiting_states.load() == 0)
+			return false;
+		std::lock_guard<std::mutex> lock(mutex);
+		if (waiting_states.empty())
+			return false;
+		state.clear();
+		state.push_back(waiting_states.back());
+		waiting_states.pop_back();
+		number_of_waiting_states.fetch_sub(1);
+		return true;
+	}
+
+	//Mark a taken state as expanded and merge its functions (if they are not given, they have been added to the front of the owner).
+	void finish(const linear_function_front<function_type>* state_results = nullptr) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (state_results != nullptr)
+				results.merge(*state_results);
+			number_of_unfinished_states.fetch_sub(1);
+		}
+		state_changed.notify_all();
+	}
+
+	//The owner calls it when it has finished its own part. It sleeps until a stored state can be taken (then it is taken as in take and true is returned)
+	//or all shared states have been expanded (then false is returned).
+	bool wait_and_take(std::vector<chord_like_type>& state) {
+		std::unique_lock<std::mutex> lock(mutex);
+		state_changed.wait(lock, [this]() { return !waiting_states.empty() || number_of_unfinished_states.load() == 0; });
+		if (waiting_states.empty())
+			return false;
+		state.clear();
+		state.push_back(waiting_states.back());
+		waiting_states.pop_back();
+		number_of_waiting_states.fetch_sub(1);
+		return true;
+	}
+
+	//Merge the functions found by other threads into the front of the owner. It should be called when the job is finished.
+	void merge_results(linear_function_front<function_type>& owner_results) {
+		std::lock_guard<std::mutex> lock(mutex);
+		owner_results.merge(results);
+	}
+};
\ No newline at end of file
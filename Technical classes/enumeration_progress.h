@@ -0,0 +1,210 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Technical classes/estimation_result.h"
+
+/*
+ This class tracks the progress of the traversal of all (pre)ACD of a given length.
+ The tree of diagrams is divided into units, i.e. subtrees starting with fixed prefixes (see collect_units).
+ A unit may be split into several tasks of the thread pool, and it is completed when all of them are finished.
+ The results of every completed unit can be saved to a checkpoint file, so that an interrupted run can be resumed without redoing completed units.
+ Since the final results are the maximum and the sum over all units, they do not depend on whether the run was interrupted.
+
+ The checkpoint file is binary. It consists of a header (see checkpoint_header) followed by the index and the results (see estimation_result::write)
+ of every completed unit. The file is deleted when all units are completed.
+*/
+
+class enumeration_progress {
+private:
+	//Technical class. The state of a unit.
+	class unit_state {
+	public:
+		std::mutex mutex;
+		int pending_tasks = 0;
+		bool is_completed = false;
+		estimation_result result;
+	};
+
+	//Technical class. The header of the checkpoint file. It is used to check that the file corresponds to the current run.
+	class checkpoint_header {
+	public:
+		char magic[8];
+		int class_id;
+		int length;
+		int split_depth;
+		int number_of_units;
+		int number_of_completed_units;
+		unsigned long long fingerprint;		// See estimation_options::get_fingerprint.
+	};
+
+	//Technical function. The first bytes of every checkpoint file.
+	static const char* get_checkpoint_magic() noexcept {
+		return "CR2CKPT6";
+	}
+
+private:
+	std::string file_name;			// If it is empty, the progress is not saved.
+	int class_id;					// 0 for ACD and 1 for preACD.
+	int length;
+	int split_depth;				// The size of the prefixes defining units.
+	int number_of_units;
+	unsigned long long fingerprint;
+	std::unique_ptr<unit_state[]> units;
+	std::atomic<int> number_of_completed_units;
+
+	std::mutex save_mutex;
+	double save_interval;			// Minimal time between two checkpoints, in seconds.
+	std::chrono::steady_clock::time_point last_save;
+
+private:
+	//Technical function. Save the results of all completed units, save_mutex should be locked. 
+	//The file is first written under a temporary name, so that an interruption during the writing does not destroy the previous checkpoint.
+	bool save_without_lock() {
+		std::vector<int> completed_units;
+		for (int i = 0; i < number_of_units; ++i) {
+			std::lock_guard<std::mutex> lock(units[i].mutex);
+			if (units[i].is_completed)
+				completed_units.push_back(i);
+		}
+		checkpoint_header header;
+		std::memcpy(header.magic, get_checkpoint_magic(), sizeof(header.magic));
+		header.class_id = class_id;
+		header.length = length;
+		header.split_depth = split_depth;
+		header.number_of_units = number_of_units;
+		header.number_of_completed_units = static_cast<int>(completed_units.size());
+		header.fingerprint = fingerprint;
+
+		std::string temp_name = file_name + ".tmp";
+		{
+			std::ofstream file_out(temp_name, std::ios::binary | std::ios::trunc);
+			file_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			for (int unit : completed_units) {
+				file_out.write(reinterpret_cast<const char*>(&unit), sizeof(unit));
+				units[unit].result.write(file_out);
+			}
+			if (!file_out)
+				return false;
+		}
+		std::remove(file_name.c_str());
+		if (std::rename(temp_name.c_str(), file_name.c_str()) != 0)
+			return false;
+		last_save = std::chrono::steady_clock::now();
+		return true;
+	}
+
+public:
+	enumeration_progress(const std::string& _file_name, int _class_id, int _length, int _split_depth, int _number_of_units, double _save_interval,
+		unsigned long long _fingerprint = 0) :
+		file_name(_file_name), class_id(_class_id), length(_length), split_depth(_split_depth), number_of_units(_number_of_units), fingerprint(_fingerprint),
+		units(new unit_state[_number_of_units]), number_of_completed_units(0), save_interval(_save_interval), last_save(std::chrono::steady_clock::now()) {}
+
+	enumeration_progress(const enumeration_progress&) = delete;
+	enumeration_progress& operator=(const enumeration_progress&) = delete;
+
+	int get_number_of_units() const noexcept {
+		return number_of_units;
+	}
+
+	//Returns the number of completed units (including the ones loaded from the checkpoint file). It can be called from any thread.
+	int get_number_of_completed_units() const noexcept {
+		return number_of_completed_units.load(std::memory_order_relaxed);
+	}
+
+	bool is_completed(int unit) noexcept {
+		std::lock_guard<std::mutex> lock(units[unit].mutex);
+		return units[unit].is_completed;
+	}
+
+	//Register a new task of the unit. It should be called before the task is given to the pool.
+	void add_task(int unit) {
+		std::lock_guard<std::mutex> lock(units[unit].mutex);
+		++units[unit].pending_tasks;
+	}
+
+	//Merge the results of a finished task into its unit. If the unit is completed, a checkpoint may be saved.
+	void finish_task(int unit, const estimation_result& result) {
+		bool is_unit_completed = false;
+		{
+			std::lock_guard<std::mutex> lock(units[unit].mutex);
+			units[unit].result += result;
+			is_unit_completed = (--units[unit].pending_tasks == 0);
+			if (is_unit_completed)
+				units[unit].is_completed = true;
+		}
+		if (is_unit_completed)
+			++number_of_completed_units;
+		if (!is_unit_completed || file_name.empty())
+			return;
+		// If another thread is saving the checkpoint right now, there is no need to wait for it.
+		std::unique_lock<std::mutex> save_lock(save_mutex, std::try_to_lock);
+		if (save_lock.owns_lock() && std::chrono::duration<double>(std::chrono::steady_clock::now() - last_save).count() > save_interval)
+			save_without_lock();
+	}
+
+	//Returns the results of all completed units.
+	estimation_result get_total() {
+		estimation_result total;
+		for (int i = 0; i < number_of_units; ++i) {
+			std::lock_guard<std::mutex> lock(units[i].mutex);
+			if (units[i].is_completed)
+				total += units[i].result;
+		}
+		return total;
+	}
+
+	//Save the results of all completed units.
+	bool save() {
+		if (file_name.empty())
+			return false;
+		std::lock_guard<std::mutex> save_lock(save_mutex);
+		return save_without_lock();
+	}
+
+	//Delete the checkpoint file. It is called when all units are completed, so a later run starts from the beginning.
+	void remove() {
+		if (file_name.empty())
+			return;
+		std::remove(file_name.c_str());
+		std::remove((file_name + ".tmp").c_str());
+	}
+
+	//Load the completed units from the checkpoint file. Returns false if there is no file or it belongs to another run 
+	//(another class, length, division into units, version of the code or settings, see estimation_options::get_fingerprint).
+	bool load() {
+		if (file_name.empty())
+			return false;
+		std::ifstream file_in(file_name, std::ios::binary);
+		checkpoint_header header;
+		if (!file_in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			return false;
+		if (std::memcmp(header.magic, get_checkpoint_magic(), sizeof(header.magic)) != 0 || header.class_id != class_id || header.length != length
+			|| header.split_depth != split_depth || header.number_of_units != number_of_units || header.fingerprint != fingerprint
+			|| header.number_of_completed_units < 0 || header.number_of_completed_units > number_of_units)
+			return false;
+		// The units are marked as completed only if the whole file is correct.
+		std::vector<std::pair<int, estimation_result>> records(header.number_of_completed_units);
+		for (auto& record : records) {
+			if (!file_in.read(reinterpret_cast<char*>(&record.first), sizeof(record.first)) || !record.second.read(file_in))
+				return false;
+			if (record.first < 0 || record.first >= number_of_units)
+				return false;
+		}
+		for (auto& record : records) {
+			units[record.first].is_completed = true;
+			units[record.first].result = std::move(record.second);
+		}
+		number_of_completed_units = static_cast<int>(records.size());
+		return true;
+	}
+};
\ No newline at end of file
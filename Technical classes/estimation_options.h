@@ -0,0 +1,102 @@
+#pragma once
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ This class contains the settings of the calculation of estimates. The default values give the plain calculation.
+*/
+
+// The version of the calculation. It is stored in the checkpoint files and in the files of the function set cache, and the files of other versions are not used.
+// It should be increased whenever a change of the code changes the numbers, e.g. a change of the transformations, of the state keys or of the LP.
+constexpr unsigned estimation_code_version = 1;
+
+class estimation_options {
+public:
+	int number_of_threads = 0;			// If it is not positive, then the number of hardware threads is used.
+
+	std::string checkpoint_prefix;		// If it is not empty, the progress of every length is saved to the file checkpoint_prefix + "_<class>_<length>.ckpt",
+										// and the calculation is resumed from this file if it exists and it was written by the same version of the code 
+										// with the same settings (see get_fingerprint). The file is deleted when the calculation of the length is completed.
+	double checkpoint_interval = 600.;	// Minimal time between two checkpoints, in seconds.
+
+	int number_of_shards = 1;			// If it is greater than 1, the units of the tree of diagrams are divided between number_of_shards independent runs,
+	int shard_index = 0;				// and only the units of the shard with the given index (from 0 to number_of_shards - 1) are processed.
+	std::vector<int> shard_boundaries;	// If it has number_of_shards + 1 elements, the shard i consists of the units from shard_boundaries[i] to shard_boundaries[i + 1] - 1
+										// (e.g. the parts of equal predicted cost, see plan_workload). Otherwise the units are dealt to the shards in turn.
+
+	std::string corpus_prefix;			// If it is not empty, the diagrams are read from the file corpus_prefix + "_<class>_<length>.corpus" (see diagram_corpus 
+										// and export_diagram_corpus) instead of being enumerated. If there is no such file, they are enumerated.
+
+	bool use_symmetry_reduction = false;	// If it is true, only one diagram of every pair of mirror images is solved, see get_symmetry_orbit_size.
+	bool use_branch_and_bound = false;		// If it is true, an LP is not solved if its upper bound is less than the maximum found so far. 
+											// The maximum is the same, but the estimates of units and shards are only correct if they are the maximum.
+
+	bool use_alglib_lp_solver = false;		// If it is true, the LPs are solved by ALGLIB (see lp_solver_context), otherwise by max_min_solver.
+	bool use_row_generation = false;		// If it is true, the LPs are solved by row generation, i.e. the solver gets only the functions needed 
+											// at the optimum (see solve_by_row_generation). The result is the same.
+
+	std::vector<double> curve_sizes;	// If it is not empty, the estimates for the starting curves of these sizes (instead of m = 8) are also found, 
+										// from the same sets of linear functions (see solve_for_curve_sizes). The sizes should be sorted.
+										// The branch and bound is not used for these estimates.
+
+	bool certify_maximum = false;			// If it is true, the estimates of the diagrams within certification_tolerance (relative) of the maximum found so far 
+	double certification_tolerance = 1e-6;	// are proved exactly (see certify_estimate), so the maximum is also given as an exact fraction, see estimation_result.
+											// The tolerance should exceed the rounding errors of the solver, then the exact maximum is among the certified estimates.
+
+	int min_moves_to_share = 0;			// If it is positive, the tree of eliminations of a diagram is shared with the idle threads of the pool, starting from
+										// the states with at least that many remaining eliminations (see elimination_job), so the largest diagrams do not hold up 
+										// the end of the calculation. The results are the same. It should not be too small:
+										// the small states are expanded faster than they are taken by another thread.
+
+	bool measure_stage_times = false;	// If it is true, the wall and the CPU time of the stages are measured, see estimation_statistics.
+	double progress_interval = 0.;		// If it is positive, the progress and the estimated remaining time are printed to std::clog every progress_interval seconds.
+	std::string statistics_file;		// If it is not empty, get_main_estimates writes the results and the statistics of every length to this file in JSON format.
+
+	int number_of_worst_diagrams = 0;	// If it is positive, the lists of that many worst diagrams with the optimal points of their LPs are kept, see estimation_result.
+										// With the branch and bound, an LP is skipped only if it cannot get into the lists of its task, 
+										// so for more than one diagram much fewer LPs are skipped.
+	std::string results_log_prefix;		// If it is not empty, the estimates of every diagram are written by every thread to its own file 
+										// results_log_prefix + "_<class>_<length>_thread<index>.log" (see results_log). The branch and bound is not used then.
+										// Notice: the units interrupted by a restart from a checkpoint are written again.
+
+	int max_cached_residual_size = 0;	// If it is positive, the sets of functions of the residual diagrams with at most that many weights are cached, 
+										// so they are not expanded again in other diagrams (see function_set_cache). About 10 is the best, larger sets are rarely reused.
+	std::string function_cache_prefix;	// If it is not empty, the cache is loaded from the file function_cache_prefix + "_<class>.cache" and saved to it at the end,
+										// so the sets are reused by all lengths and by later runs.
+
+	//Returns a hash of the version of the code and of the settings which change the results (the estimates, the lists of diagrams and the units 
+	//of the shard). It is stored in the checkpoint files, so a calculation is not resumed from a file written with other settings,
+	//and in the shard files (with shard_index = 0), so the shards of different settings are not merged (see merge_shard_files).
+	unsigned long long get_fingerprint() const noexcept {
+		unsigned long long hash = 14695981039346656037ull;
+		auto add = [&hash](unsigned long long value) {
+			for (int i = 0; i < 8; ++i, value >>= 8) {
+				hash ^= value & 255;
+				hash *= 1099511628211ull;
+			}
+		};
+		auto add_double = [&add](double value) {
+			unsigned long long bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			add(bits);
+		};
+		add(estimation_code_version);
+		add(number_of_shards);
+		add(shard_index);
+		add(shard_boundaries.size());
+		for (int boundary : shard_boundaries)
+			add(static_cast<unsigned>(boundary));
+		add(use_symmetry_reduction);
+		add(use_branch_and_bound && results_log_prefix.empty());	// The log turns the branch and bound off.
+		add(use_alglib_lp_solver);
+		add(use_row_generation);
+		add(curve_sizes.size());
+		for (double size : curve_sizes)
+			add_double(size);
+		add(certify_maximum);
+		add_double(certification_tolerance);
+		add(static_cast<unsigned>(number_of_worst_diagrams));
+		return hash;
+	}
+};
\ No newline at end of file
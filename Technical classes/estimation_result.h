@@ -0,0 +1,397 @@
+#pragma once
+#include <algorithm>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ This class represents the results of the traversal of a set of (pre)ACD: the maximum estimates, the diagrams giving them and the number of diagrams.
+ A diagram is stored as the vector rhs_lhs it is constructed from. If several diagrams give the same estimate, the lexicographically smallest one is stored,
+ i.e. the one that comes first in walk_trough_all_diagrams. So the result does not depend on the order in which the diagrams were considered.
+
+ If number_of_worst_diagrams is positive, the lists of that many diagrams with the largest estimates are also kept, together with the optimal points of their LPs.
+ The lists are sorted in the same order (larger estimates first, then lexicographically smaller diagrams), so they do not depend on the order either.
+ They are short, so they are kept as sorted vectors, and a new diagram is inserted only if it is better than the last one.
+
+ If curve_sizes is not empty, the maximum estimates for these sizes m of the starting curve (instead of m = 8) and the diagrams giving them are also kept,
+ see curve_sizes in estimation_options.
+
+ If the estimates are certified (see certify_maximum in estimation_options), the largest exact estimates among the certified diagrams are kept as fractions.
+*/
+
+//Technical class. A diagram with its estimate and the optimal point of its LP.
+class diagram_estimate {
+public:
+	double value = -1.;
+	std::vector<int> diagram;
+	std::vector<double> solution;			// The optimal values of x[1], ..., x[n] (see create_solver), or nothing if they are unknown.
+};
+
+//Technical class. An exact estimate of a diagram, the irreducible fraction numerator / denominator (see certify_estimate).
+//The denominator is 0 if nothing is certified. The terms are less than 2^31, so the fractions are compared exactly in long long.
+class certified_estimate {
+public:
+	long long numerator = 0;
+	long long denominator = 0;
+	std::vector<int> diagram;
+
+public:
+	bool is_certified() const noexcept {
+		return denominator > 0;
+	}
+
+	double get_value() const noexcept {
+		return is_certified() ? static_cast<double>(numerator) / denominator : -1.;
+	}
+
+	//Returns true if the estimate goes before the other one, i.e. it is larger or the same for a lexicographically smaller diagram.
+	bool is_worse_than(const certified_estimate& other) const noexcept {
+		if (!other.is_certified())
+			return is_certified();
+		if (!is_certified())
+			return false;
+		long long difference = numerator * other.denominator - other.numerator * denominator;
+		return difference > 0 || (difference == 0 && diagram < other.diagram);
+	}
+};
+
+class estimation_result {
+public:
+	double value_8 = -1.;					// The maximum estimates.
+	double value_limit = -1.;
+	std::vector<int> worst_diagram_8;		// The diagrams giving the maximum estimates.
+	std::vector<int> worst_diagram_limit;
+	long long number_of_diag = 0;			// The number of diagrams considered.
+
+	int number_of_worst_diagrams = 0;					// The maximal size of the lists below.
+	std::vector<diagram_estimate> worst_diagrams_8;		// The diagrams with the largest estimates, the first ones are the worst.
+	std::vector<diagram_estimate> worst_diagrams_limit;
+
+	std::vector<double> curve_sizes;						// The sizes of the starting curve, usually none.
+	std::vector<double> curve_size_values;					// The maximum estimates for these sizes.
+	std::vector<std::vector<int>> curve_size_worst_diagrams;	// The diagrams giving them.
+
+	certified_estimate certified_8;			// The largest certified estimates, usually none.
+	certified_estimate certified_limit;
+
+private:
+	//Technical function. Update the maximum value and the corresponding diagram.
+	static void update_maximum(double& value, std::vector<int>& worst_diagram, double new_value, const std::vector<int>& diagram) {
+		if (new_value > value || (new_value == value && diagram < worst_diagram)) {
+			value = new_value;
+			worst_diagram = diagram;
+		}
+	}
+
+	//Technical function. Returns true if the first diagram goes before the second one in the lists of the worst diagrams.
+	static bool is_worse(double value, const std::vector<int>& diagram, double other_value, const std::vector<int>& other_diagram) {
+		return value > other_value || (value == other_value && diagram < other_diagram);
+	}
+
+	//Technical function. Insert the diagram into the list of the worst diagrams if it is among the number_of_worst_diagrams worst ones.
+	void update_worst_diagrams(std::vector<diagram_estimate>& worst_diagrams, double new_value, const std::vector<int>& diagram, 
+		const std::vector<double>* solution) {
+		if (static_cast<int>(worst_diagrams.size()) >= number_of_worst_diagrams 
+			&& (worst_diagrams.empty() || !is_worse(new_value, diagram, worst_diagrams.back().value, worst_diagrams.back().diagram)))
+			return;
+		auto position = std::find_if(worst_diagrams.begin(), worst_diagrams.end(), [&](const diagram_estimate& estimate) { 
+			return is_worse(new_value, diagram, estimate.value, estimate.diagram); });
+		diagram_estimate estimate;
+		estimate.value = new_value;
+		estimate.diagram = diagram;
+		if (solution != nullptr)
+			estimate.solution = *solution;
+		worst_diagrams.insert(position, std::move(estimate));
+		if (static_cast<int>(worst_diagrams.size()) > number_of_worst_diagrams)
+			worst_diagrams.pop_back();
+	}
+
+	//Technical functions for binary input and output.
+	static void write_vector(std::ostream& stream_out, const std::vector<int>& v) {
+		int size = static_cast<int>(v.size());
+		stream_out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		for (int c : v) {
+			signed char symbol = static_cast<signed char>(c);
+			stream_out.write(reinterpret_cast<const char*>(&symbol), sizeof(symbol));
+		}
+	}
+
+	static bool read_vector(std::istream& stream_in, std::vector<int>& v) {
+		int size = 0;
+		if (!stream_in.read(reinterpret_cast<char*>(&size), sizeof(size)) || size < 0 || size > 256)
+			return false;
+		v.resize(size);
+		for (auto& c : v) {
+			signed char symbol = 0;
+			if (!stream_in.read(reinterpret_cast<char*>(&symbol), sizeof(symbol)))
+				return false;
+			c = symbol;
+		}
+		return true;
+	}
+
+	static void write_worst_diagrams(std::ostream& stream_out, const std::vector<diagram_estimate>& worst_diagrams) {
+		int size = static_cast<int>(worst_diagrams.size());
+		stream_out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		for (const auto& estimate : worst_diagrams) {
+			stream_out.write(reinterpret_cast<const char*>(&estimate.value), sizeof(estimate.value));
+			write_vector(stream_out, estimate.diagram);
+			int solution_size = static_cast<int>(estimate.solution.size());
+			stream_out.write(reinterpret_cast<const char*>(&solution_size), sizeof(solution_size));
+			stream_out.write(reinterpret_cast<const char*>(estimate.solution.data()), sizeof(double) * solution_size);
+		}
+	}
+
+	static bool read_worst_diagrams(std::istream& stream_in, std::vector<diagram_estimate>& worst_diagrams) {
+		int size = 0;
+		if (!stream_in.read(reinterpret_cast<char*>(&size), sizeof(size)) || size < 0 || size > 1000000)
+			return false;
+		worst_diagrams.resize(size);
+		for (auto& estimate : worst_diagrams) {
+			int solution_size = 0;
+			if (!stream_in.read(reinterpret_cast<char*>(&estimate.value), sizeof(estimate.value)) || !read_vector(stream_in, estimate.diagram)
+				|| !stream_in.read(reinterpret_cast<char*>(&solution_size), sizeof(solution_size)) || solution_size < 0 || solution_size > 256)
+				return false;
+			estimate.solution.resize(solution_size);
+			if (!stream_in.read(reinterpret_cast<char*>(estimate.solution.data()), sizeof(double) * solution_size))
+				return false;
+		}
+		return true;
+	}
+
+	static void write_doubles(std::ostream& stream_out, const std::vector<double>& v) {
+		int size = static_cast<int>(v.size());
+		stream_out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		stream_out.write(reinterpret_cast<const char*>(v.data()), sizeof(double) * size);
+	}
+
+	static bool read_doubles(std::istream& stream_in, std::vector<double>& v) {
+		int size = 0;
+		if (!stream_in.read(reinterpret_cast<char*>(&size), sizeof(size)) || size < 0 || size > 1000000)
+			return false;
+		v.resize(size);
+		return static_cast<bool>(stream_in.read(reinterpret_cast<char*>(v.data()), sizeof(double) * size));
+	}
+
+	static void write_certified_estimate(std::ostream& stream_out, const certified_estimate& estimate) {
+		stream_out.write(reinterpret_cast<const char*>(&estimate.numerator), sizeof(estimate.numerator));
+		stream_out.write(reinterpret_cast<const char*>(&estimate.denominator), sizeof(estimate.denominator));
+		write_vector(stream_out, estimate.diagram);
+	}
+
+	static bool read_certified_estimate(std::istream& stream_in, certified_estimate& estimate) {
+		return stream_in.read(reinterpret_cast<char*>(&estimate.numerator), sizeof(estimate.numerator))
+			&& stream_in.read(reinterpret_cast<char*>(&estimate.denominator), sizeof(estimate.denominator))
+			&& read_vector(stream_in, estimate.diagram);
+	}
+
+	static void print_certified_estimate(std::ostream& stream_out, const char* name, const certified_estimate& estimate) {
+		stream_out << name << " " << estimate.numerator << " " << estimate.denominator << " " << estimate.diagram.size();
+		for (int c : estimate.diagram)
+			stream_out << " " << c;
+		stream_out << "\n";
+	}
+
+	static void scan_certified_estimate(std::istream& stream_in, certified_estimate& estimate) {
+		std::string name;
+		size_t size = 0;
+		stream_in >> name >> estimate.numerator >> estimate.denominator >> size;
+		estimate.diagram.resize(size);
+		for (auto& c : estimate.diagram)
+			stream_in >> c;
+	}
+
+	//Technical function. It reads the diagrams of the sizes of the starting curve, one for every value.
+	bool read_curve_size_worst_diagrams(std::istream& stream_in) {
+		curve_size_worst_diagrams.resize(curve_size_values.size());
+		for (auto& diagram : curve_size_worst_diagrams)
+			if (!read_vector(stream_in, diagram))
+				return false;
+		return true;
+	}
+
+	//Technical functions for text input and output of the lists of the worst diagrams.
+	static void print_worst_diagrams(std::ostream& stream_out, const char* name, const std::vector<diagram_estimate>& worst_diagrams) {
+		stream_out << name << " " << worst_diagrams.size() << "\n";
+		for (const auto& estimate : worst_diagrams) {
+			stream_out << estimate.value << " " << estimate.diagram.size();
+			for (int c : estimate.diagram)
+				stream_out << " " << c;
+			stream_out << " " << estimate.solution.size();
+			for (double x : estimate.solution)
+				stream_out << " " << x;
+			stream_out << "\n";
+		}
+	}
+
+	static void scan_worst_diagrams(std::istream& stream_in, std::vector<diagram_estimate>& worst_diagrams) {
+		std::string name;
+		size_t size = 0;
+		stream_in >> name >> size;
+		worst_diagrams.resize(size);
+		for (auto& estimate : worst_diagrams) {
+			stream_in >> estimate.value >> size;
+			estimate.diagram.resize(size);
+			for (auto& c : estimate.diagram)
+				stream_in >> c;
+			stream_in >> size;
+			estimate.solution.resize(size);
+			for (auto& x : estimate.solution)
+				stream_in >> x;
+		}
+	}
+
+public:
+	//Add the estimates of one more diagram. If it represents several diagrams with the same estimates (e.g. mirror images), 
+	//their number is given by multiplicity. The optimal points of the LPs are used only for the lists of the worst diagrams.
+	void add_diagram(const std::vector<int>& diagram, double new_value_8, double new_value_limit, int multiplicity = 1,
+		const std::vector<double>* solution_8 = nullptr, const std::vector<double>* solution_limit = nullptr) {
+		number_of_diag += multiplicity;
+		update_maximum(value_8, worst_diagram_8, new_value_8, diagram);
+		update_maximum(value_limit, worst_diagram_limit, new_value_limit, diagram);
+		if (number_of_worst_diagrams > 0) {
+			update_worst_diagrams(worst_diagrams_8, new_value_8, diagram, solution_8);
+			update_worst_diagrams(worst_diagrams_limit, new_value_limit, diagram, solution_limit);
+		}
+	}
+
+	//Add the estimates of one more diagram for the sizes of the starting curve (in the order of curve_sizes).
+	void add_curve_size_values(const std::vector<int>& diagram, const std::vector<double>& values) {
+		curve_size_values.resize(curve_sizes.size(), -1.);
+		curve_size_worst_diagrams.resize(curve_sizes.size());
+		for (size_t i = 0; i < curve_sizes.size(); ++i)
+			update_maximum(curve_size_values[i], curve_size_worst_diagrams[i], values[i], diagram);
+	}
+
+	//Add the certified estimate numerator / denominator of one more diagram for one of the cases.
+	void add_certified_estimate(const std::vector<int>& diagram, bool is_limit_case, long long numerator, long long denominator) {
+		certified_estimate estimate;
+		estimate.numerator = numerator;
+		estimate.denominator = denominator;
+		estimate.diagram = diagram;
+		certified_estimate& certified = is_limit_case ? certified_limit : certified_8;
+		if (estimate.is_worse_than(certified))
+			certified = std::move(estimate);
+	}
+
+	//Returns the estimate a new diagram should exceed to get into the list of the worst diagrams, or -1 if the list is not full.
+	double get_worst_diagrams_threshold(bool is_limit_case) const noexcept {
+		const auto& worst_diagrams = is_limit_case ? worst_diagrams_limit : worst_diagrams_8;
+		return static_cast<int>(worst_diagrams.size()) < number_of_worst_diagrams || worst_diagrams.empty() ? -1. : worst_diagrams.back().value;
+	}
+
+	estimation_result& operator+=(const estimation_result& other) {
+		update_maximum(value_8, worst_diagram_8, other.value_8, other.worst_diagram_8);
+		update_maximum(value_limit, worst_diagram_limit, other.value_limit, other.worst_diagram_limit);
+		number_of_diag += other.number_of_diag;
+		number_of_worst_diagrams = std::max(number_of_worst_diagrams, other.number_of_worst_diagrams);
+		for (const auto& estimate : other.worst_diagrams_8)
+			update_worst_diagrams(worst_diagrams_8, estimate.value, estimate.diagram, &estimate.solution);
+		for (const auto& estimate : other.worst_diagrams_limit)
+			update_worst_diagrams(worst_diagrams_limit, estimate.value, estimate.diagram, &estimate.solution);
+		if (curve_sizes.empty())
+			curve_sizes = other.curve_sizes;
+		curve_size_values.resize(curve_sizes.size(), -1.);
+		curve_size_worst_diagrams.resize(curve_sizes.size());
+		for (size_t i = 0; i < other.curve_size_values.size() && i < curve_sizes.size(); ++i)
+			update_maximum(curve_size_values[i], curve_size_worst_diagrams[i], other.curve_size_values[i], other.curve_size_worst_diagrams[i]);
+		if (other.certified_8.is_worse_than(certified_8))
+			certified_8 = other.certified_8;
+		if (other.certified_limit.is_worse_than(certified_limit))
+			certified_limit = other.certified_limit;
+		return *this;
+	}
+
+	//Binary output, used in checkpoint files.
+	void write(std::ostream& stream_out) const {
+		stream_out.write(reinterpret_cast<const char*>(&value_8), sizeof(value_8));
+		stream_out.write(reinterpret_cast<const char*>(&value_limit), sizeof(value_limit));
+		stream_out.write(reinterpret_cast<const char*>(&number_of_diag), sizeof(number_of_diag));
+		write_vector(stream_out, worst_diagram_8);
+		write_vector(stream_out, worst_diagram_limit);
+		stream_out.write(reinterpret_cast<const char*>(&number_of_worst_diagrams), sizeof(number_of_worst_diagrams));
+		write_worst_diagrams(stream_out, worst_diagrams_8);
+		write_worst_diagrams(stream_out, worst_diagrams_limit);
+		write_doubles(stream_out, curve_sizes);
+		write_doubles(stream_out, curve_size_values);
+		for (const auto& diagram : curve_size_worst_diagrams)
+			write_vector(stream_out, diagram);
+		write_certified_estimate(stream_out, certified_8);
+		write_certified_estimate(stream_out, certified_limit);
+	}
+
+	bool read(std::istream& stream_in) {
+		return stream_in.read(reinterpret_cast<char*>(&value_8), sizeof(value_8))
+			&& stream_in.read(reinterpret_cast<char*>(&value_limit), sizeof(value_limit))
+			&& stream_in.read(reinterpret_cast<char*>(&number_of_diag), sizeof(number_of_diag))
+			&& read_vector(stream_in, worst_diagram_8)
+			&& read_vector(stream_in, worst_diagram_limit)
+			&& stream_in.read(reinterpret_cast<char*>(&number_of_worst_diagrams), sizeof(number_of_worst_diagrams))
+			&& read_worst_diagrams(stream_in, worst_diagrams_8)
+			&& read_worst_diagrams(stream_in, worst_diagrams_limit)
+			&& read_doubles(stream_in, curve_sizes)
+			&& read_doubles(stream_in, curve_size_values)
+			&& read_curve_size_worst_diagrams(stream_in)
+			&& read_certified_estimate(stream_in, certified_8)
+			&& read_certified_estimate(stream_in, certified_limit);
+	}
+
+	//Text output. The values are written with 17 significant digits, so they are read back exactly.
+	friend std::ostream& operator<<(std::ostream& stream_out, const estimation_result& result) {
+		stream_out << std::setprecision(17)
+			<< "diagrams " << result.number_of_diag << "\n"
+			<< "value_8 " << result.value_8 << "\n"
+			<< "value_limit " << result.value_limit << "\n"
+			<< "worst_diagram_8 " << result.worst_diagram_8.size();
+		for (int c : result.worst_diagram_8)
+			stream_out << " " << c;
+		stream_out << "\nworst_diagram_limit " << result.worst_diagram_limit.size();
+		for (int c : result.worst_diagram_limit)
+			stream_out << " " << c;
+		stream_out << "\nnumber_of_worst_diagrams " << result.number_of_worst_diagrams << "\n";
+		print_worst_diagrams(stream_out, "worst_diagrams_8", result.worst_diagrams_8);
+		print_worst_diagrams(stream_out, "worst_diagrams_limit", result.worst_diagrams_limit);
+		stream_out << "curve_sizes " << result.curve_size_values.size() << "\n";
+		for (size_t i = 0; i < result.curve_size_values.size(); ++i) {
+			stream_out << result.curve_sizes[i] << " " << result.curve_size_values[i] << " " << result.curve_size_worst_diagrams[i].size();
+			for (int c : result.curve_size_worst_diagrams[i])
+				stream_out << " " << c;
+			stream_out << "\n";
+		}
+		print_certified_estimate(stream_out, "certified_8", result.certified_8);
+		print_certified_estimate(stream_out, "certified_limit", result.certified_limit);
+		return stream_out;
+	}
+
+	friend std::istream& operator>>(std::istream& stream_in, estimation_result& result) {
+		std::string name;
+		size_t size = 0;
+		stream_in >> name >> result.number_of_diag >> name >> result.value_8 >> name >> result.value_limit;
+		stream_in >> name >> size;
+		result.worst_diagram_8.resize(size);
+		for (auto& c : result.worst_diagram_8)
+			stream_in >> c;
+		stream_in >> name >> size;
+		result.worst_diagram_limit.resize(size);
+		for (auto& c : result.worst_diagram_limit)
+			stream_in >> c;
+		stream_in >> name >> result.number_of_worst_diagrams;
+		scan_worst_diagrams(stream_in, result.worst_diagrams_8);
+		scan_worst_diagrams(stream_in, result.worst_diagrams_limit);
+		stream_in >> name >> size;
+		result.curve_sizes.resize(size);
+		result.curve_size_values.resize(size);
+		result.curve_size_worst_diagrams.resize(size);
+		for (size_t i = 0; i < result.curve_sizes.size(); ++i) {
+			stream_in >> result.curve_sizes[i] >> result.curve_size_values[i] >> size;
+			result.curve_size_worst_diagrams[i].resize(size);
+			for (auto& c : result.curve_size_worst_diagrams[i])
+				stream_in >> c;
+		}
+		scan_certified_estimate(stream_in, result.certified_8);
+		scan_certified_estimate(stream_in, result.certified_limit);
+		return stream_in;
+	}
+};
\ No newline at end of file
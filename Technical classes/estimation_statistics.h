@@ -0,0 +1,154 @@
+#pragma once
+#include <ostream>
+#include <iomanip>
+
+#include "Technical classes/stage_timer.h"
+
+/*
+ This class collects counters that describe the work done during the estimation.
+ Every thread fills its own copy, and the copies are summed up at the end.
+ The times of the stages are measured only if measure_stage_times is set in estimation_options, and they are summed over all threads (see stage_timer).
+*/
+
+class estimation_statistics {
+public:
+	long long number_of_states = 0;				// The number of elimination states looked up in the transposition table.
+	long long number_of_repeated_states = 0;	// The number of states that have already been expanded, so their subtrees are cut off.
+	long long number_of_lp = 0;					// The number of solved linear programming problems.
+	long long number_of_skipped_lp = 0;			// The number of LPs skipped by the branch and bound.
+	long long number_of_lp_iterations = 0;		// The total number of iterations of the LP solver.
+	long long number_of_linear_functions = 0;	// The number of linear functions obtained before the dominance filtering.
+	long long number_of_lp_rows = 0;			// The number of linear functions that remain after the filtering, i.e. the rows of the LP.
+	long long number_of_row_generation_rounds = 0;	// The number of LPs solved by the row generation (see solve_by_row_generation).
+	long long number_of_generated_rows = 0;		// The number of rows of the last LPs of the row generation, i.e. the rows really passed to the solver.
+	long long number_of_curve_size_lp = 0;		// The number of LPs solved for other sizes of the starting curve (see solve_for_curve_sizes).
+	long long number_of_curve_size_iterations = 0;	// The number of iterations of the LP solver for them.
+	long long number_of_certified_lp = 0;		// The number of LPs solved exactly near the maximum (see certify_estimate).
+	long long number_of_failed_certificates = 0;	// The number of them whose floating-point basis was not proved optimal.
+	long long number_of_mirrored_diagrams = 0;	// The number of diagrams skipped since their mirror images are considered.
+	long long number_of_diagrams = 0;			// The number of interesting diagrams constructed by the enumeration.
+	long long number_of_pruned_prefixes = 0;	// The number of prefixes cut off by not_interesting.
+	long long number_of_residual_lookups = 0;	// The number of residual diagrams looked up in the cache of function sets (see function_set_cache).
+	long long number_of_residual_hits = 0;		// The number of residual diagrams whose sets were found in the cache.
+	long long number_of_shared_states = 0;		// The number of elimination states given to other threads (see elimination_job).
+	long long number_of_helped_states = 0;		// The number of them expanded by a thread which does not own the diagram.
+
+	stage_time traversal_time;					// The whole traversal of the tree of diagrams, including the two stages below.
+	stage_time elimination_time;				// The construction of the linear functions (see all_linear_functions_in_place).
+	stage_time lp_time;							// The LP solver.
+
+public:
+	estimation_statistics& operator+=(const estimation_statistics& other) noexcept {
+		number_of_states += other.number_of_states;
+		number_of_repeated_states += other.number_of_repeated_states;
+		number_of_lp += other.number_of_lp;
+		number_of_skipped_lp += other.number_of_skipped_lp;
+		number_of_lp_iterations += other.number_of_lp_iterations;
+		number_of_linear_functions += other.number_of_linear_functions;
+		number_of_lp_rows += other.number_of_lp_rows;
+		number_of_row_generation_rounds += other.number_of_row_generation_rounds;
+		number_of_generated_rows += other.number_of_generated_rows;
+		number_of_curve_size_lp += other.number_of_curve_size_lp;
+		number_of_curve_size_iterations += other.number_of_curve_size_iterations;
+		number_of_certified_lp += other.number_of_certified_lp;
+		number_of_failed_certificates += other.number_of_failed_certificates;
+		number_of_mirrored_diagrams += other.number_of_mirrored_diagrams;
+		number_of_diagrams += other.number_of_diagrams;
+		number_of_pruned_prefixes += other.number_of_pruned_prefixes;
+		number_of_residual_lookups += other.number_of_residual_lookups;
+		number_of_residual_hits += other.number_of_residual_hits;
+		number_of_shared_states += other.number_of_shared_states;
+		number_of_helped_states += other.number_of_helped_states;
+		traversal_time += other.traversal_time;
+		elimination_time += other.elimination_time;
+		lp_time += other.lp_time;
+		return *this;
+	}
+
+	//The time of the enumeration of diagrams, i.e. the time of the traversal except the elimination and the LP solver.
+	stage_time get_enumeration_time() const noexcept {
+		stage_time time = traversal_time;
+		time -= elimination_time;
+		time -= lp_time;
+		return time;
+	}
+
+	double get_hit_rate() const noexcept {
+		return number_of_states == 0 ? 0. : static_cast<double>(number_of_repeated_states) / number_of_states;
+	}
+
+	friend std::ostream& operator<<(std::ostream& stream_out, const estimation_statistics& stat) {
+		stream_out
+			<< "Elimination states considered: " << stat.number_of_states
+			<< ", cut off by the transposition table: " << stat.number_of_repeated_states
+			<< " (" << std::fixed << std::setprecision(2) << 100. * stat.get_hit_rate() << "%)"
+			<< ". LP solved: " << stat.number_of_lp
+			<< ", skipped by the branch and bound: " << stat.number_of_skipped_lp
+			<< ", iterations of the LP solver: " << stat.number_of_lp_iterations
+			<< ", linear functions: " << stat.number_of_linear_functions
+			<< ", rows after the dominance filtering: " << stat.number_of_lp_rows;
+		if (stat.number_of_row_generation_rounds > 0)
+			stream_out << ", rows generated: " << stat.number_of_generated_rows << " in " << stat.number_of_row_generation_rounds << " rounds";
+		if (stat.number_of_curve_size_lp > 0)
+			stream_out << ", LP solved for other sizes of the curve: " << stat.number_of_curve_size_lp 
+				<< " (" << stat.number_of_curve_size_iterations << " iterations)";
+		if (stat.number_of_certified_lp > 0)
+			stream_out << ", LP certified exactly: " << stat.number_of_certified_lp << " (not proved: " << stat.number_of_failed_certificates << ")";
+		stream_out
+			<< ". Diagrams constructed: " << stat.number_of_diagrams
+			<< ", prefixes cut off as not interesting: " << stat.number_of_pruned_prefixes
+			<< ", skipped as mirror images: " << stat.number_of_mirrored_diagrams;
+		if (stat.number_of_residual_lookups > 0)
+			stream_out << ". Residual diagrams looked up in the cache: " << stat.number_of_residual_lookups 
+				<< ", found: " << stat.number_of_residual_hits;
+		if (stat.number_of_shared_states > 0)
+			stream_out << ". Elimination states shared: " << stat.number_of_shared_states 
+				<< ", expanded by other threads: " << stat.number_of_helped_states;
+		if (stat.traversal_time.wall_time > 0.) {
+			stream_out << ". Wall (CPU) time of all threads: enumeration ";
+			write_time(stream_out, stat.get_enumeration_time());
+			stream_out << ", elimination ";
+			write_time(stream_out, stat.elimination_time);
+			stream_out << ", LP solver ";
+			write_time(stream_out, stat.lp_time);
+		}
+		return stream_out;
+	}
+
+	//Write the statistics as a JSON object.
+	void write_json(std::ostream& stream_out) const {
+		stream_out << std::setprecision(6) << std::fixed
+			<< "{\"states\": " << number_of_states
+			<< ", \"repeated_states\": " << number_of_repeated_states
+			<< ", \"lp\": " << number_of_lp
+			<< ", \"skipped_lp\": " << number_of_skipped_lp
+			<< ", \"lp_iterations\": " << number_of_lp_iterations
+			<< ", \"linear_functions\": " << number_of_linear_functions
+			<< ", \"lp_rows\": " << number_of_lp_rows
+			<< ", \"row_generation_rounds\": " << number_of_row_generation_rounds
+			<< ", \"generated_rows\": " << number_of_generated_rows
+			<< ", \"curve_size_lp\": " << number_of_curve_size_lp
+			<< ", \"curve_size_iterations\": " << number_of_curve_size_iterations
+			<< ", \"certified_lp\": " << number_of_certified_lp
+			<< ", \"failed_certificates\": " << number_of_failed_certificates
+			<< ", \"mirrored_diagrams\": " << number_of_mirrored_diagrams
+			<< ", \"diagrams\": " << number_of_diagrams
+			<< ", \"pruned_prefixes\": " << number_of_pruned_prefixes
+			<< ", \"residual_lookups\": " << number_of_residual_lookups
+			<< ", \"residual_hits\": " << number_of_residual_hits
+			<< ", \"shared_states\": " << number_of_shared_states
+			<< ", \"helped_states\": " << number_of_helped_states;
+		stage_time enumeration_time = get_enumeration_time();
+		const char* names[] = { "enumeration", "elimination", "lp" };
+		const stage_time* times[] = { &enumeration_time, &elimination_time, &lp_time };
+		for (int i = 0; i < 3; ++i)
+			stream_out << ", \"" << names[i] << "_wall_time\": " << times[i]->wall_time << ", \"" << names[i] << "_cpu_time\": " << times[i]->cpu_time;
+		stream_out << "}";
+	}
+
+private:
+	//Technical function. Writes the wall and the CPU time of a stage.
+	static void write_time(std::ostream& stream_out, const stage_time& time) {
+		stream_out << std::fixed << std::setprecision(2) << time.wall_time << " (" << time.cpu_time << ") sec";
+	}
+};
\ No newline at end of file
@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "Technical classes/big_integer.h"
+
+/*
+ This class finds the exact value of the problem solved by max_min_solver (maximize min_j f_j(x) over 0 <= x[i], x[1] + ... + x[n] <= m)
+ and proves it, given the optimal basis found in floating point (see max_min_solver::get_optimal_basis). The coefficients of the functions
+ and m are integers, so the matrix G of the game (see max_min_solver) and its shift G' = G + shift with positive entries are integer too.
+
+ If R are the basic rows and C the columns with tight constraints, the square block M = G'[R][C] is solved exactly: z = M^-1 * 1 and w = M^-T * 1.
+ If z >= 0, w >= 0, (G' z)[j] >= 1 for all rows j and (G'^T w)[i] <= 1 for all columns i, then z / sum(z) is a strategy of the second player
+ guaranteeing at least 1 / sum(z) and w / sum(w) is a strategy of the first player giving at most 1 / sum(w) = 1 / sum(z), so the value of G'
+ is exactly 1 / sum(z), and the value of the problem is 1 / sum(z) - shift. Otherwise the basis is not optimal (e.g. the rounding errors have led
+ the solver to a wrong basis in a degenerate problem), and nothing is proved.
+
+ The systems are solved by the fraction-free Gauss-Jordan elimination (Bareiss), so all divisions are exact and z is the integer vector Z divided
+ by the determinant D of M. All checks are comparisons of integers, e.g. (G' Z)[j] >= D. The integers may exceed 64 bits, so big_integer is used.
+ The containers are kept between calls, so every thread should use its own object.
+*/
+
+class exact_lp_certificate {
+private:
+	int num_of_columns;						// n + 1, as in max_min_solver.
+	int num_of_rows;
+	long long shift;
+	std::vector<long long> matrix;			// The matrix G', row by row.
+	std::vector<big_integer> system;		// The augmented matrix of the system being solved.
+	std::vector<big_integer> column_weights;	// Z, in the order of the coordinates.
+	std::vector<big_integer> row_weights;		// The same for w, in the order of the rows.
+	big_integer numerator;					// The value of the problem is numerator / denominator, the fraction is irreducible.
+	big_integer denominator;
+
+private:
+	//Technical function. It solves the system given by the augmented s x (s + 1) matrix in system by the fraction-free Gauss-Jordan elimination.
+	//The solution is x / determinant, where the determinant is positive. Returns false if the matrix is singular.
+	bool solve_system(int s, std::vector<big_integer>& x, big_integer& determinant) {
+		int width = s + 1;
+		auto entry = [&](int i, int j) -> big_integer& { return system[static_cast<size_t>(i) * width + j]; };
+		big_integer previous_pivot = 1;
+		for (int c = 0; c < s; ++c) {
+			int p = c;
+			while (p < s && entry(p, c).is_zero())
+				++p;
+			if (p == s)
+				return false;
+			if (p != c)
+				for (int j = 0; j < width; ++j)
+					std::swap(entry(p, j), entry(c, j));
+			// Every entry outside the pivot row becomes a minor of the matrix divided by the previous one, so the division is exact.
+			for (int i = 0; i < s; ++i) {
+				if (i == c)
+					continue;
+				for (int j = 0; j < width; ++j)
+					if (j != c)
+						entry(i, j) = (entry(c, c) * entry(i, j) - entry(i, c) * entry(c, j)) / previous_pivot;
+				entry(i, c) = 0;
+			}
+			previous_pivot = entry(c, c);
+		}
+		// Now every diagonal entry is the last pivot, i.e. the determinant up to the sign.
+		int sign = previous_pivot.sign();
+		determinant = sign > 0 ? previous_pivot : -previous_pivot;
+		x.resize(s);
+		for (int i = 0; i < s; ++i)
+			x[i] = sign > 0 ? entry(i, s) : -entry(i, s);
+		return true;
+	}
+
+public:
+	exact_lp_certificate() noexcept : num_of_columns(0), num_of_rows(0), shift(0) {}
+
+	exact_lp_certificate(const exact_lp_certificate&) = delete;
+	exact_lp_certificate& operator=(const exact_lp_certificate&) = delete;
+
+	//Returns true if the basis (see max_min_solver::get_optimal_basis) is optimal for the problem with the given functions and the integer m.
+	//Then the exact value is given by get_value.
+	template<class container_type>
+	bool check(const container_type& all_linear_functions, long long m, const std::vector<int>& rows, const std::vector<int>& coordinates) {
+		num_of_columns = all_linear_functions.cbegin()->get_number_of_variables();
+		num_of_rows = static_cast<int>(all_linear_functions.size());
+		int k = num_of_columns, s = static_cast<int>(rows.size());
+		if (s == 0 || s != static_cast<int>(coordinates.size()))
+			return false;
+
+		matrix.resize(static_cast<size_t>(num_of_rows) * k);
+		long long* row = matrix.data();
+		long long min_entry = 0;
+		for (const auto& p : all_linear_functions) {
+			row[0] = p.get_coef_under_variable(0);
+			for (int i = 1; i < k; ++i)
+				row[i] = row[0] + m * p.get_coef_under_variable(i);
+			min_entry = std::min(min_entry, *std::min_element(row, row + k));
+			row += k;
+		}
+		shift = 1 - min_entry;
+		for (long long& entry : matrix)
+			entry += shift;
+		auto g = [&](int j, int i) { return matrix[static_cast<size_t>(j) * k + i]; };
+
+		// The strategy of the second player: M z = 1.
+		big_integer determinant;
+		system.assign(static_cast<size_t>(s) * (s + 1), big_integer(1));
+		for (int a = 0; a < s; ++a)
+			for (int b = 0; b < s; ++b)
+				system[static_cast<size_t>(a) * (s + 1) + b] = g(rows[a], coordinates[b]);
+		if (!solve_system(s, column_weights, determinant))
+			return false;
+		big_integer sum_of_weights = 0;
+		for (const auto& weight : column_weights) {
+			if (weight.sign() < 0)
+				return false;
+			sum_of_weights = sum_of_weights + weight;
+		}
+		for (int j = 0; j < num_of_rows; ++j) {
+			big_integer product = 0;
+			for (int b = 0; b < s; ++b)
+				product = product + big_integer(g(j, coordinates[b])) * column_weights[b];
+			if (product < determinant)
+				return false;
+		}
+
+		// The strategy of the first player: M^T w = 1.
+		big_integer row_determinant;
+		system.assign(static_cast<size_t>(s) * (s + 1), big_integer(1));
+		for (int a = 0; a < s; ++a)
+			for (int b = 0; b < s; ++b)
+				system[static_cast<size_t>(a) * (s + 1) + b] = g(rows[b], coordinates[a]);
+		if (!solve_system(s, row_weights, row_determinant))
+			return false;
+		for (const auto& weight : row_weights)
+			if (weight.sign() < 0)
+				return false;
+		for (int i = 0; i < k; ++i) {
+			big_integer product = 0;
+			for (int b = 0; b < s; ++b)
+				product = product + big_integer(g(rows[b], i)) * row_weights[b];
+			if (product > row_determinant)
+				return false;
+		}
+
+		// The value is determinant / sum_of_weights - shift.
+		numerator = determinant - big_integer(shift) * sum_of_weights;
+		denominator = sum_of_weights;
+		big_integer divisor = big_integer::gcd(numerator, denominator);
+		numerator = numerator / divisor;
+		denominator = denominator / divisor;
+		return true;
+	}
+
+	const big_integer& get_numerator() const noexcept {
+		return numerator;
+	}
+
+	const big_integer& get_denominator() const noexcept {
+		return denominator;
+	}
+
+	//Writes the value of the last proved problem as a fraction of two integers, if their absolute values are not greater than max_value.
+	bool get_value(long long& value_numerator, long long& value_denominator, long long max_value) const noexcept {
+		return numerator.to_long_long(value_numerator, max_value) && denominator.to_long_long(value_denominator, max_value);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Technical classes/estimation_options.h"
+
+/*
+ This class stores the sets of linear functions of residual diagrams, i.e. of the states of the eliminations, so that they are not expanded again
+ in other diagrams, for other lengths and in later runs (see all_linear_functions_in_place).
+ All transformations add the linear functions of the letters (or weights) with non-negative integer coefficients, so every function obtained below
+ a state is increaser + c + a[1] * w[1] + ... + a[r] * w[r], where w[i] are the functions of the letters, and the vectors (c, a[1], ..., a[r])
+ depend only on the residual diagram and the number of remaining eliminations. They are calculated once with the letters replaced by variables,
+ and only the non-dominated ones are stored (a dominated vector gives a dominated function for all letters, since their coefficients are not negative).
+
+ The key is the canonical encoding of the residual diagram without the functions (see get_residual_key in ACD_in_place and pre_ACD_in_place)
+ followed by the number of remaining eliminations and is_limit_case. The value is the list of vectors, r + 1 numbers each.
+ Only residual diagrams with at most max_number_of_weights letters are stored, which limits the size of the cache.
+ The cache is shared by all threads: the lookups take a shared lock and the insertions an exclusive one. The stored sets are never removed,
+ so the pointers returned by find and insert remain valid.
+ The cache can be saved to a binary file and loaded from it, see save and load. The file depends only on the class of diagrams and on the version
+ of the code (see estimation_code_version), which is stored after the magic, so the sets of an older version are never spliced in.
+*/
+
+class function_set_cache {
+private:
+	//Technical class. FNV-1a hash of the key.
+	class key_hash {
+	public:
+		size_t operator()(const std::vector<int>& key) const noexcept {
+			unsigned long long hash = 14695981039346656037ull;
+			for (int value : key) {
+				hash ^= static_cast<unsigned int>(value);
+				hash *= 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	static const char* get_file_magic() noexcept {
+		return "CR2FSC02";
+	}
+
+	int max_number_of_weights;
+	std::unordered_map<std::vector<int>, std::vector<int>, key_hash> sets;
+	mutable std::shared_timed_mutex mutex;
+	size_t number_of_saved_sets;				// The number of sets in the file (if nothing has been added after load or save, there is nothing to save).
+	std::atomic<long long> number_of_lookups;
+	std::atomic<long long> number_of_hits;
+
+public:
+	explicit function_set_cache(int _max_number_of_weights) :
+		max_number_of_weights(_max_number_of_weights), number_of_saved_sets(0), number_of_lookups(0), number_of_hits(0) {}
+
+	function_set_cache(const function_set_cache&) = delete;
+	function_set_cache& operator=(const function_set_cache&) = delete;
+
+	int get_max_number_of_weights() const noexcept {
+		return max_number_of_weights;
+	}
+
+	//Returns the stored set for the key, or nullptr if there is no such set.
+	const std::vector<int>* find(const std::vector<int>& key) {
+		++number_of_lookups;
+		std::shared_lock<std::shared_timed_mutex> lock(mutex);
+		auto iter = sets.find(key);
+		if (iter == sets.end())
+			return nullptr;
+		++number_of_hits;
+		return &iter->second;
+	}
+
+	//Store the set for the key and return the stored set. If another thread has stored a set for the same key, it is kept (it is the same).
+	const std::vector<int>* insert(const std::vector<int>& key, std::vector<int>&& functions) {
+		std::unique_lock<std::shared_timed_mutex> lock(mutex);
+		return &sets.emplace(key, std::move(functions)).first->second;
+	}
+
+	size_t size() const {
+		std::shared_lock<std::shared_timed_mutex> lock(mutex);
+		return sets.size();
+	}
+
+	long long get_number_of_lookups() const noexcept {
+		return number_of_lookups;
+	}
+
+	long long get_number_of_hits() const noexcept {
+		return number_of_hits;
+	}
+
+	//Read the sets from the file. A missing file is an empty cache. Returns false if the file has a wrong format or another version
+	//(the sets read before the error are kept, so an incomplete last record, e.g. after an interrupted save, is ignored).
+	bool load(const std::string& file_name) {
+		std::ifstream file_in(file_name, std::ios::binary);
+		if (!file_in)
+			return true;
+		char magic[8];
+		unsigned version = 0;
+		if (!file_in.read(magic, sizeof(magic)) || std::memcmp(magic, get_file_magic(), sizeof(magic)) != 0
+			|| !file_in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != estimation_code_version)
+			return false;
+		std::unique_lock<std::shared_timed_mutex> lock(mutex);
+		int sizes[2];
+		while (file_in.read(reinterpret_cast<char*>(sizes), sizeof(sizes))) {
+			if (sizes[0] < 0 || sizes[1] < 0)
+				return false;
+			std::vector<int> key(sizes[0]), functions(sizes[1]);
+			if (!file_in.read(reinterpret_cast<char*>(key.data()), sizeof(int) * key.size())
+				|| !file_in.read(reinterpret_cast<char*>(functions.data()), sizeof(int) * functions.size()))
+				break;
+			sets.emplace(std::move(key), std::move(functions));
+		}
+		number_of_saved_sets = sets.size();
+		return true;
+	}
+
+	//Write all sets to the file, if some sets have been added since the last load or save.
+	//The file is first written under a temporary name and then renamed, so an interrupted save does not damage the previous file.
+	//Returns false if the file cannot be written.
+	bool save(const std::string& file_name) {
+		std::unique_lock<std::shared_timed_mutex> lock(mutex);
+		if (sets.size() == number_of_saved_sets)
+			return true;
+		std::string temp_name = file_name + ".tmp";
+		{
+			std::ofstream file_out(temp_name, std::ios::binary | std::ios::trunc);
+			file_out.write(get_file_magic(), 8);
+			file_out.write(reinterpret_cast<const char*>(&estimation_code_version), sizeof(estimation_code_version));
+			for (const auto& set : sets) {
+				int sizes[2] = { static_cast<int>(set.first.size()), static_cast<int>(set.second.size()) };
+				file_out.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+				file_out.write(reinterpret_cast<const char*>(set.first.data()), sizeof(int) * set.first.size());
+				file_out.write(reinterpret_cast<const char*>(set.second.data()), sizeof(int) * set.second.size());
+			}
+			if (!file_out)
+				return false;
+		}
+		std::remove(file_name.c_str());
+		if (std::rename(temp_name.c_str(), file_name.c_str()) != 0)
+			return false;
+		number_of_saved_sets = sets.size();
+		return true;
+	}
+};
\ No newline at end of file
@@ -1,19 +1,74 @@
 #pragma once
 #include <unordered_map>
 #include <ostream>
+#include <vector>
+
+// SSE2 is available on every x86-64 processor. Define LINEAR_FUNCTION_NO_SIMD to use the scalar code instead.
+#if !defined(LINEAR_FUNCTION_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define LINEAR_FUNCTION_USE_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
 
 /*
  This class represents multivariable linear functions with integer coefficients.
  A number of basic operations are defined: arithmetic and comparison operations.
- Note: a fixed-length array is used for storage, so make sure that the number of variables is not too large.
-*/
+ Note: a fixed-length array is used for storage. Its size is given by the template parameter, i.e. by the maximal number of variables 
+ (the constant term included), and the actual number of variables may be smaller.
 
-constexpr int n_max = 10;
+ The array is aligned and padded to a whole number of SSE registers (4 coefficients each), and all unused coefficients are zero.
+ So the operations process the whole array with a fixed number of vector instructions instead of looping to actual_num_of_variables.
+ Zero coefficients do not change the sums, the products and the results of comparisons, so the results are the same as for the scalar loops.
+*/
 
+template<int max_num_of_variables>
 class linear_function {
+public:
+	static constexpr int lanes_per_register = 4;
+	static constexpr int storage_size = (max_num_of_variables + lanes_per_register - 1) / lanes_per_register * lanes_per_register;
+
+private:
+	alignas(16) int variable_and_coef[storage_size] = {};
+	int actual_num_of_variables = 0;
+
 private:
-	int variable_and_coef[3 + 2 * n_max];
-	int actual_num_of_variables;
+#ifdef LINEAR_FUNCTION_USE_SSE2
+	//Technical function. The index of the lowest set bit of a non-zero mask.
+	static int get_lowest_bit(unsigned mask) noexcept {
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanForward(&index, mask);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	//Technical function. The register with the coefficients block*4, ..., block*4+3.
+	__m128i get_register(int block) const noexcept {
+		return _mm_load_si128(reinterpret_cast<const __m128i*>(variable_and_coef) + block);
+	}
+#endif
+
+	//Technical function. Returns the index of the first coefficient that differs from the one of p, or storage_size if the functions are equal.
+	int get_first_difference(const linear_function& p) const noexcept {
+#ifdef LINEAR_FUNCTION_USE_SSE2
+		for (int block = 0; block < storage_size / lanes_per_register; ++block) {
+			__m128i equal = _mm_cmpeq_epi32(get_register(block), p.get_register(block));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+			if (mask != 0xF)
+				return block * lanes_per_register + get_lowest_bit(~mask & 0xF);
+		}
+		return storage_size;
+#else
+		for (int i = 0; i < storage_size; ++i)
+			if (variable_and_coef[i] != p.variable_and_coef[i])
+				return i;
+		return storage_size;
+#endif
+	}
 
 public:
 	linear_function() = default;
@@ -24,7 +79,6 @@ public:
 	linear_function& operator=(linear_function&&) = default;
 
 	linear_function(int variable, int value, int _num_of_v) noexcept : actual_num_of_variables(_num_of_v) {
-		memset(variable_and_coef, 0, sizeof(int) * _num_of_v);
 		variable_and_coef[variable] = value;
 	}
 
@@ -36,53 +90,87 @@ public:
 		return actual_num_of_variables;
 	}
 
+	//Append all the coefficients to the end of the vector. It is used to encode states of chord diagrams.
+	void append_coefficients(std::vector<int>& key) const {
+		key.insert(key.end(), variable_and_coef, variable_and_coef + actual_num_of_variables);
+	}
+
+	//SSE2 has no 32-bit multiplication, but the loop has a fixed length, so the compiler vectorizes it when it is possible.
 	linear_function& operator*=(int mult) noexcept {
-		for (int i = 0; i < actual_num_of_variables; ++i)
+		for (int i = 0; i < storage_size; ++i)
 			variable_and_coef[i] *= mult;
 		return *this;
 	}
 
 	linear_function& operator+=(const linear_function& p) noexcept {
-		for (int i = 0; i < actual_num_of_variables; ++i) 
+#ifdef LINEAR_FUNCTION_USE_SSE2
+		__m128i* data = reinterpret_cast<__m128i*>(variable_and_coef);
+		for (int block = 0; block < storage_size / lanes_per_register; ++block)
+			_mm_store_si128(data + block, _mm_add_epi32(get_register(block), p.get_register(block)));
+#else
+		for (int i = 0; i < storage_size; ++i)
 			variable_and_coef[i] += p.variable_and_coef[i];
+#endif
+		return *this;
+	}
+
+	//It is used to revert additions, e.g. in ACD_in_place::undo.
+	linear_function& operator-=(const linear_function& p) noexcept {
+#ifdef LINEAR_FUNCTION_USE_SSE2
+		__m128i* data = reinterpret_cast<__m128i*>(variable_and_coef);
+		for (int block = 0; block < storage_size / lanes_per_register; ++block)
+			_mm_store_si128(data + block, _mm_sub_epi32(get_register(block), p.get_register(block)));
+#else
+		for (int i = 0; i < storage_size; ++i)
+			variable_and_coef[i] -= p.variable_and_coef[i];
+#endif
 		return *this;
 	}
 
 	linear_function& operator+=(int coef) noexcept {
-		variable_and_coef[0];
 		variable_and_coef[0] += coef;
 		return *this;
 	}
 
+	//Returns the same function without the constant term.
+	linear_function get_linear_part() const noexcept {
+		linear_function p(*this);
+		p.variable_and_coef[0] = 0;
+		return p;
+	}
+
 	bool operator==(const linear_function& _p) const noexcept {
-		for (int i = 0; i < actual_num_of_variables; ++i) 
-			if (variable_and_coef[i] != _p.variable_and_coef[i])
-				return false;
-		return true;
+		return get_first_difference(_p) == storage_size;
 	}
 
 	bool operator>=(const linear_function& p) const noexcept {
-		for (int i = 0; i < actual_num_of_variables; ++i) {
-			if (variable_and_coef[i] < p.variable_and_coef[i])
-				return false;
-			if (variable_and_coef[i] > p.variable_and_coef[i])
-				return true;
-		}
-		return true;
+		int i = get_first_difference(p);
+		return i == storage_size || variable_and_coef[i] > p.variable_and_coef[i];
 	}
 
 	bool operator<=(const linear_function& p) const noexcept {
 		return p >= *this;
 	}
 
-	bool operator<(const linear_function& _p) const noexcept {
-		for (int i = 0; i < actual_num_of_variables - 1; ++i) {
-			if (variable_and_coef[i] < _p.variable_and_coef[i])
-				return true;
-			if (variable_and_coef[i] > _p.variable_and_coef[i])
+	//Returns true if every coefficient (the constant included) is not less than the corresponding coefficient of p.
+	//In this case the function is not less than p for all non-negative values of the variables.
+	bool is_dominated_by(const linear_function& p) const noexcept {
+#ifdef LINEAR_FUNCTION_USE_SSE2
+		__m128i less = _mm_setzero_si128();
+		for (int block = 0; block < storage_size / lanes_per_register; ++block)
+			less = _mm_or_si128(less, _mm_cmplt_epi32(get_register(block), p.get_register(block)));
+		return _mm_movemask_epi8(less) == 0;
+#else
+		for (int i = 0; i < storage_size; ++i)
+			if (variable_and_coef[i] < p.variable_and_coef[i])
 				return false;
-		}
-		return variable_and_coef[actual_num_of_variables - 1] < _p.variable_and_coef[actual_num_of_variables - 1];
+		return true;
+#endif
+	}
+
+	bool operator<(const linear_function& _p) const noexcept {
+		int i = get_first_difference(_p);
+		return i != storage_size && variable_and_coef[i] < _p.variable_and_coef[i];
 	}
 
 	bool operator>(const linear_function& _p) const noexcept {
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+
+#include "Technical classes/linear_function_coefficients.h"
+
+/*
+ This class represents a set of linear functions without dominated elements (a Pareto front).
+ We are only interested in the minimum of the functions for non-negative values of the variables. 
+ If all coefficients of a function f are not less than the coefficients of some other function g, then f is never less than g,
+ and f can be dropped. So a new function is not inserted if it is dominated by one of the stored functions, 
+ and otherwise all stored functions dominated by the new one are removed.
+ The template parameter is the type of the functions, i.e. linear_function of the appropriate size.
+*/
+
+template<class function_type>
+class linear_function_front {
+private:
+	std::vector<function_type> functions;
+	long long number_of_offered_functions;	// The number of calls of insert, i.e. the number of functions before the filtering.
+
+public:
+	linear_function_front() noexcept : number_of_offered_functions(0) {}
+
+	//Add a function to the front. Returns false if the function is dominated by one of the stored functions (or coincides with it).
+	bool insert(const function_type& f) {
+		++number_of_offered_functions;
+		for (const auto& g : functions)
+			if (f.is_dominated_by(g))
+				return false;
+		for (size_t i = 0; i < functions.size();) {
+			if (functions[i].is_dominated_by(f)) {
+				functions[i] = functions.back();
+				functions.pop_back();
+			}
+			else
+				++i;
+		}
+		functions.push_back(f);
+		return true;
+	}
+
+	//Add all functions of another front. The functions offered to it are counted as offered to this one.
+	void merge(const linear_function_front& other) {
+		for (const auto& f : other.functions)
+			insert(f);
+		number_of_offered_functions += other.number_of_offered_functions - static_cast<long long>(other.functions.size());
+	}
+
+	void clear() noexcept {
+		functions.clear();
+		number_of_offered_functions = 0;
+	}
+
+	size_t size() const noexcept {
+		return functions.size();
+	}
+
+	bool empty() const noexcept {
+		return functions.empty();
+	}
+
+	long long get_number_of_offered_functions() const noexcept {
+		return number_of_offered_functions;
+	}
+
+	typename std::vector<function_type>::const_iterator begin() const noexcept {
+		return functions.cbegin();
+	}
+
+	typename std::vector<function_type>::const_iterator end() const noexcept {
+		return functions.cend();
+	}
+
+	typename std::vector<function_type>::const_iterator cbegin() const noexcept {
+		return functions.cbegin();
+	}
+
+	typename std::vector<function_type>::const_iterator cend() const noexcept {
+		return functions.cend();
+	}
+};
\ No newline at end of file
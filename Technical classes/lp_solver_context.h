@@ -0,0 +1,137 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "alglib/optimization.h"	// This is a part of ALGLIB library, see https://www.alglib.net/
+
+#include "Technical classes/linear_function_front.h"
+
+/*
+ This class solves the same linear programming problem as create_solver (see brute_force_functions.h), but it keeps all ALGLIB objects between calls.
+ Consecutive diagrams of the same length give problems of the same dimension, so the bounds, the cost, the scales and the solver state
+ are created only when the dimension or m changes, and the matrix of inequalities is reallocated only when it needs more rows.
+ The matrix is a contiguous row-major buffer attached to the ALGLIB array, so the rows are written directly in the layout of the LP.
+ Every thread should use its own context.
+
+ The solution of the previous problem is also kept. ALGLIB does not allow to pass a starting point or a basis to minlp,
+ so it is not used to start the next solve, but it can be read by get_solution.
+*/
+
+class lp_solver_context {
+private:
+	int num_of_variables;					// The number of variables of the current state, or -1 if the state has not been created.
+	double m;								// The size of the starting curve the current bounds correspond to.
+	int capacity;							// The number of rows allocated in matrix.
+
+	alglib::real_1d_array bounds_lower;		// Lower bounds on the variables value
+	alglib::real_1d_array bounds_upper;		// Upper bound on the variables value
+	alglib::real_1d_array cost;				// Minimization function
+	alglib::real_1d_array scales;			// Scales is a technical parameter, see https://www.alglib.net/optimization/scaling.php
+
+	std::vector<double> matrix;				// Matrix for the main set of inequalities, row by row (only the first rows are used)
+	alglib::real_2d_array a;				// The same matrix, attached to the buffer
+	alglib::real_1d_array a_lower;			// Lower bounds for each inequality
+	alglib::real_1d_array a_upper;			// Upper bounds for each inequality
+
+	alglib::real_1d_array solution;
+	alglib::minlpstate state;
+	alglib::minlpreport rep;
+
+	long long number_of_iterations;			// The total number of iterations of the solver.
+
+private:
+	//Technical function. Create the state and the bounds if the dimension or m has changed.
+	void prepare(int _num_of_variables, double _m) {
+		if (_num_of_variables != num_of_variables) {
+			num_of_variables = _num_of_variables;
+			m = -1.;
+			capacity = 0;
+			bounds_lower.setlength(num_of_variables);
+			bounds_upper.setlength(num_of_variables);
+			cost.setlength(num_of_variables);
+			scales.setlength(num_of_variables);
+			for (int i = 0; i < num_of_variables; ++i) {
+				cost[i] = 0.;
+				scales[i] = 1.;
+			}
+			// In our case its -1*x[n+1].
+			cost[num_of_variables - 1] = -1.;
+			alglib::minlpcreate(num_of_variables, state);
+			alglib::minlpsetcost(state, cost);
+			alglib::minlpsetscale(state, scales);
+		}
+		if (_m != m) {
+			m = _m;
+			// In our case x[0] = 1 (it is a constant), 0 <= x[i] <= m (for i=1,2,...,n) and x[n+1] is free.
+			for (int i = 0; i < num_of_variables; ++i) {
+				bounds_lower[i] = 0.;
+				bounds_upper[i] = m;
+			}
+			bounds_lower[0] = bounds_upper[0] = 1.;
+			bounds_lower[num_of_variables - 1] = alglib::fp_neginf;
+			bounds_upper[num_of_variables - 1] = alglib::fp_posinf;
+			alglib::minlpsetbc(state, bounds_lower, bounds_upper);
+		}
+	}
+
+public:
+	lp_solver_context() noexcept : num_of_variables(-1), m(-1.), capacity(0), number_of_iterations(0) {}
+
+	lp_solver_context(const lp_solver_context&) = delete;
+	lp_solver_context& operator=(const lp_solver_context&) = delete;
+
+	//Returns the solution of the problem for the given set of linear functions, i.e. the maximum over x of the minimum of the functions.
+	//The set is a linear_function_front or any other container of linear functions, e.g. a subset of the front (see solve_by_row_generation).
+	template<class container_type>
+	double solve(const container_type& all_linear_functions, bool is_limit_case) {
+		prepare(all_linear_functions.cbegin()->get_number_of_variables() + 1, is_limit_case ? 1. : 8.);
+		int num_of_inequalities = static_cast<int>(all_linear_functions.size()) + 1;
+
+		// The matrix and the bounds of inequalities grow geometrically, so they are reallocated only a few times.
+		if (num_of_inequalities > capacity) {
+			capacity = std::max(num_of_inequalities, 2 * capacity);
+			matrix.resize(static_cast<size_t>(capacity) * num_of_variables);
+			a_lower.setlength(capacity);
+			a_upper.setlength(capacity);
+		}
+
+		// The inequalities have the form 0 <= f_j(x) - x[n+1] < inf
+		double* row = matrix.data();
+		int i_ineq = 0;
+		for (const auto& p : all_linear_functions) {
+			for (int i_var = 0; i_var < num_of_variables - 1; ++i_var)
+				row[i_var] = p.get_coef_under_variable(i_var);
+			row[num_of_variables - 1] = -1.;
+			a_lower[i_ineq] = 0.;
+			a_upper[i_ineq] = alglib::fp_posinf;
+			row += num_of_variables;
+			++i_ineq;
+		}
+		// The last inequality: 0 <= x[1] + x[2] + ... + x[n] <= m
+		row[0] = 0.;
+		for (int i_var = 1; i_var < num_of_variables - 1; ++i_var)
+			row[i_var] = 1.;
+		row[num_of_variables - 1] = 0.;
+		a_lower[i_ineq] = 0.;
+		a_upper[i_ineq] = m;
+
+		// The buffer may have been reallocated, so the array is attached every time.
+		a.attach_to_ptr(num_of_inequalities, num_of_variables, matrix.data());
+
+		alglib::minlpsetlc2dense(state, a, a_lower, a_upper, num_of_inequalities);
+		alglib::minlpoptimize(state);
+		alglib::minlpresultsbuf(state, solution, rep);
+		number_of_iterations += rep.iterationscount;
+
+		return solution[num_of_variables - 1];
+	}
+
+	//Returns the solution point of the last problem: x[0] = 1, then x[1], ..., x[n], and the value x[n+1].
+	const alglib::real_1d_array& get_solution() const noexcept {
+		return solution;
+	}
+
+	long long get_number_of_iterations() const noexcept {
+		return number_of_iterations;
+	}
+};
\ No newline at end of file
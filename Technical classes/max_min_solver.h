@@ -0,0 +1,341 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Technical classes/linear_function_front.h"
+
+/*
+ This class solves the same problem as create_solver (see brute_force_functions.h) without ALGLIB, using its special structure:
+ maximize min_j f_j(x) over the set 0 <= x[i], x[1] + ... + x[n] <= m (the bounds x[i] <= m follow from the last inequality).
+ This set is a simplex with the vertices 0 and m * e_i, so x is a convex combination of them with weights y[0], y[1], ..., y[n], and
+ f_j(x) = sum_i G[j][i] * y[i], where G[j][0] = f_j(0) and G[j][i] = f_j(0) + m * (the coefficient of f_j under x[i]).
+ Thus the solution is the value of the matrix game G, in which the first player chooses a row j and the second one chooses a column i.
+
+ After adding a constant to all entries of G they are positive, and the value of the game is 1 / (the maximum of w[1] + ... + w[k])
+ over w >= 0 with (G^T w)[i] <= 1 for all columns i. This LP has only n + 1 constraints, the slacks give a feasible starting basis, and its
+ dual variables are y divided by the value. It is solved by the revised simplex method with the explicit inverse of the basis,
+ so an iteration costs O(n^2) plus the pricing of all rows in O(n * (number of rows)). The largest reduced cost is chosen, and Bland's rule
+ is used after a series of degenerate pivots, so the method does not cycle.
+
+ The returned value is the minimum of the functions at the obtained point x, i.e. it is always attained, and it differs from the optimum only by rounding errors.
+ The containers are kept between calls, so every thread should use its own solver.
+*/
+
+class max_min_solver {
+private:
+	static constexpr double tolerance = 1e-9;			// The minimal reduced cost of the entering column and the minimal pivot.
+	static constexpr int reinversion_interval = 64;		// The inverse of the basis is recalculated from scratch after this number of pivots.
+
+	int num_of_columns;						// n + 1, the number of vertices of the simplex.
+	int num_of_rows;						// The number of functions.
+	std::vector<double> matrix;				// The matrix G with positive entries, row by row.
+	std::vector<int> basis;					// For every constraint, the basic variable: a row of G (0, ..., num_of_rows - 1) or a slack (num_of_rows + i).
+	std::vector<double> basis_inverse;		// num_of_columns x num_of_columns, row by row.
+	std::vector<double> basic_values;		// The values of the basic variables.
+	std::vector<double> prices;				// The dual variables, i.e. y divided by the value of the game.
+	std::vector<double> column;				// The column of the entering variable.
+	std::vector<double> entering_column;	// The same column multiplied by basis_inverse.
+	std::vector<int> basic_rows;			// The following containers are used only to recalculate the inverse of the basis, see reinvert.
+	std::vector<int> free_coordinates;
+	std::vector<char> is_covered;
+	std::vector<double> block;
+	std::vector<double> block_inverse;
+	std::vector<double> solution;			// x[0] = 1, x[1], ..., x[n] and the value.
+	long long number_of_iterations;
+
+private:
+	//Technical function. The column of the variable in the constraints (G^T w)[i] <= 1, written to values.
+	void get_column(int variable, std::vector<double>& values) const {
+		if (variable < num_of_rows)
+			std::copy_n(matrix.begin() + static_cast<size_t>(variable) * num_of_columns, num_of_columns, values.begin());
+		else {
+			std::fill(values.begin(), values.end(), 0.);
+			values[variable - num_of_rows] = 1.;
+		}
+	}
+
+	//Technical function. Recalculate basis_inverse and basic_values. The bases of the simplex method are never singular, but the basis 
+	//of the previous problem may be singular for a new one (see solve_for_curve_size), and then the function returns false.
+	//Most basic variables are usually slacks, i.e. unit columns, so only the block of the basic rows of G at the coordinates without basic slacks
+	//(a square matrix M) is inverted by the Gauss-Jordan elimination. If the basic rows are w[b] and the slack of the coordinate i is basic, then
+	//w = M^-1 * (the right-hand side at these coordinates) and the slack is the right-hand side at i minus (G^T w)[i].
+	bool reinvert() {
+		int k = num_of_columns;
+		basic_rows.clear();
+		free_coordinates.clear();
+		is_covered.assign(k, 0);
+		for (int r = 0; r < k; ++r) {
+			if (basis[r] < num_of_rows)
+				basic_rows.push_back(r);
+			else
+				is_covered[basis[r] - num_of_rows] = 1;
+		}
+		for (int i = 0; i < k; ++i)
+			if (!is_covered[i])
+				free_coordinates.push_back(i);
+		int s = static_cast<int>(basic_rows.size());
+
+		// block[a][b] = G[the row of basic_rows[b]][free_coordinates[a]], and block_inverse is its inverse.
+		block.resize(static_cast<size_t>(s) * s);
+		block_inverse.assign(static_cast<size_t>(s) * s, 0.);
+		for (int a = 0; a < s; ++a) {
+			for (int b = 0; b < s; ++b)
+				block[static_cast<size_t>(a) * s + b] = matrix[static_cast<size_t>(basis[basic_rows[b]]) * k + free_coordinates[a]];
+			block_inverse[static_cast<size_t>(a) * s + a] = 1.;
+		}
+		for (int c = 0; c < s; ++c) {
+			int p = c;
+			for (int i = c + 1; i < s; ++i)
+				if (std::abs(block[static_cast<size_t>(i) * s + c]) > std::abs(block[static_cast<size_t>(p) * s + c]))
+					p = i;
+			for (int j = 0; j < s; ++j) {
+				std::swap(block[static_cast<size_t>(c) * s + j], block[static_cast<size_t>(p) * s + j]);
+				std::swap(block_inverse[static_cast<size_t>(c) * s + j], block_inverse[static_cast<size_t>(p) * s + j]);
+			}
+			double pivot = block[static_cast<size_t>(c) * s + c];
+			if (std::abs(pivot) < tolerance)
+				return false;
+			for (int j = 0; j < s; ++j) {
+				block[static_cast<size_t>(c) * s + j] /= pivot;
+				block_inverse[static_cast<size_t>(c) * s + j] /= pivot;
+			}
+			for (int i = 0; i < s; ++i) {
+				double factor = block[static_cast<size_t>(i) * s + c];
+				if (i == c || factor == 0.)
+					continue;
+				for (int j = 0; j < s; ++j) {
+					block[static_cast<size_t>(i) * s + j] -= factor * block[static_cast<size_t>(c) * s + j];
+					block_inverse[static_cast<size_t>(i) * s + j] -= factor * block_inverse[static_cast<size_t>(c) * s + j];
+				}
+			}
+		}
+
+		std::fill(basis_inverse.begin(), basis_inverse.end(), 0.);
+		for (int b = 0; b < s; ++b)
+			for (int a = 0; a < s; ++a)
+				basis_inverse[static_cast<size_t>(basic_rows[b]) * k + free_coordinates[a]] = block_inverse[static_cast<size_t>(b) * s + a];
+		for (int r = 0; r < k; ++r) {
+			if (basis[r] < num_of_rows)
+				continue;
+			int i = basis[r] - num_of_rows;
+			double* row = basis_inverse.data() + static_cast<size_t>(r) * k;
+			row[i] = 1.;
+			for (int b = 0; b < s; ++b) {
+				double g = matrix[static_cast<size_t>(basis[basic_rows[b]]) * k + i];
+				const double* inverse_row = basis_inverse.data() + static_cast<size_t>(basic_rows[b]) * k;
+				for (int a = 0; a < s; ++a)
+					row[free_coordinates[a]] -= g * inverse_row[free_coordinates[a]];
+			}
+		}
+		// The right-hand side is the vector of ones.
+		for (int r = 0; r < k; ++r) {
+			basic_values[r] = 0.;
+			for (int i = 0; i < k; ++i)
+				basic_values[r] += basis_inverse[static_cast<size_t>(r) * k + i];
+		}
+		return true;
+	}
+
+	//Technical function. The prices are the costs of the basic variables (1 for the rows of G and 0 for the slacks) multiplied by basis_inverse.
+	void update_prices() {
+		int k = num_of_columns;
+		std::fill(prices.begin(), prices.end(), 0.);
+		for (int r = 0; r < k; ++r)
+			if (basis[r] < num_of_rows)
+				for (int i = 0; i < k; ++i)
+					prices[i] += basis_inverse[static_cast<size_t>(r) * k + i];
+	}
+
+	//Technical function. Returns the entering variable or -1 if the basis is optimal.
+	//The reduced cost of a row j of G is 1 - prices * G[j], and the one of a slack i is -prices[i].
+	int choose_entering_variable(bool use_blands_rule) const {
+		int entering = -1;
+		double max_reduced_cost = tolerance;
+		const double* row = matrix.data();
+		for (int j = 0; j < num_of_rows; ++j, row += num_of_columns) {
+			double reduced_cost = 1.;
+			for (int i = 0; i < num_of_columns; ++i)
+				reduced_cost -= prices[i] * row[i];
+			if (reduced_cost > max_reduced_cost) {
+				entering = j;
+				if (use_blands_rule)
+					return entering;
+				max_reduced_cost = reduced_cost;
+			}
+		}
+		for (int i = 0; i < num_of_columns; ++i)
+			if (-prices[i] > max_reduced_cost) {
+				entering = num_of_rows + i;
+				if (use_blands_rule)
+					return entering;
+				max_reduced_cost = -prices[i];
+			}
+		return entering;
+	}
+
+public:
+	max_min_solver() noexcept : num_of_columns(0), num_of_rows(0), number_of_iterations(0) {}
+
+	max_min_solver(const max_min_solver&) = delete;
+	max_min_solver& operator=(const max_min_solver&) = delete;
+
+	//Returns the solution of the problem for the given set of linear functions, i.e. the maximum over x of the minimum of the functions.
+	//The set is a linear_function_front or any other container of linear functions, e.g. a subset of the front (see solve_by_row_generation).
+	template<class container_type>
+	double solve(const container_type& all_linear_functions, bool is_limit_case) {
+		return solve_for_curve_size(all_linear_functions, (is_limit_case) ? 1. : 8.);
+	}
+
+	//Returns the solution of the same problem for the starting curve of size m, i.e. with x[1] + ... + x[n] <= m.
+	//If use_previous_basis is true and the functions are the same as in the previous call (only m is different), the simplex method starts 
+	//from the optimal basis of the previous problem if it is feasible for the new one. For close values of m it is usually optimal or almost optimal,
+	//so a sweep over m (see solve_for_curve_sizes) takes a few pivots per value. Otherwise the method starts from the slacks.
+	template<class container_type>
+	double solve_for_curve_size(const container_type& all_linear_functions, double m, bool use_previous_basis = false) {
+		int previous_num_of_columns = num_of_columns, previous_num_of_rows = num_of_rows;
+		num_of_columns = all_linear_functions.cbegin()->get_number_of_variables();
+		num_of_rows = static_cast<int>(all_linear_functions.size());
+		int k = num_of_columns;
+		use_previous_basis = use_previous_basis && previous_num_of_columns == num_of_columns && previous_num_of_rows == num_of_rows;
+
+		// The matrix of the game. The entries are shifted, so that all of them are at least 1.
+		matrix.resize(static_cast<size_t>(num_of_rows) * k);
+		double* row = matrix.data();
+		double min_entry = 0.;
+		for (const auto& p : all_linear_functions) {
+			row[0] = p.get_coef_under_variable(0);
+			for (int i = 1; i < k; ++i)
+				row[i] = row[0] + m * p.get_coef_under_variable(i);
+			min_entry = std::min(min_entry, *std::min_element(row, row + k));
+			row += k;
+		}
+		double shift = 1. - min_entry;
+		for (double& entry : matrix)
+			entry += shift;
+
+		prices.resize(k);
+		column.resize(k);
+		entering_column.resize(k);
+		// The previous basis is used if it is not singular and its basic solution is feasible (up to the rounding errors).
+		if (use_previous_basis)
+			use_previous_basis = reinvert() && *std::min_element(basic_values.begin(), basic_values.end()) >= -tolerance;
+		if (!use_previous_basis) {
+			// The starting basis consists of the slacks.
+			basis.resize(k);
+			basis_inverse.assign(static_cast<size_t>(k) * k, 0.);
+			basic_values.assign(k, 1.);
+			for (int r = 0; r < k; ++r) {
+				basis[r] = num_of_rows + r;
+				basis_inverse[static_cast<size_t>(r) * k + r] = 1.;
+			}
+		}
+
+		int number_of_degenerate_pivots = 0, number_of_pivots = 0;
+		while (true) {
+			update_prices();
+			int entering = choose_entering_variable(number_of_degenerate_pivots > k);
+			if (entering < 0)
+				break;
+
+			// entering_column = basis_inverse * (the column of the entering variable).
+			get_column(entering, column);
+			for (int r = 0; r < k; ++r) {
+				double sum = 0.;
+				for (int i = 0; i < k; ++i)
+					sum += basis_inverse[static_cast<size_t>(r) * k + i] * column[i];
+				entering_column[r] = sum;
+			}
+
+			// The ratio test. The ties are resolved by the smallest basic variable, as in Bland's rule.
+			// The entries of G are positive, so the problem is bounded and some pivot exists.
+			double min_ratio = -1.;
+			for (int r = 0; r < k; ++r)
+				if (entering_column[r] > tolerance) {
+					double ratio = std::max(basic_values[r], 0.) / entering_column[r];
+					if (min_ratio < 0. || ratio < min_ratio)
+						min_ratio = ratio;
+				}
+			if (min_ratio < 0.)
+				break;
+			int leaving = -1;
+			for (int r = 0; r < k; ++r)
+				if (entering_column[r] > tolerance && std::max(basic_values[r], 0.) / entering_column[r] <= min_ratio + 1e-12
+					&& (leaving < 0 || basis[r] < basis[leaving]))
+					leaving = r;
+			number_of_degenerate_pivots = min_ratio <= 1e-12 ? number_of_degenerate_pivots + 1 : 0;
+
+			// The pivot on entering_column[leaving].
+			double pivot = entering_column[leaving];
+			double* leaving_row = basis_inverse.data() + static_cast<size_t>(leaving) * k;
+			for (int i = 0; i < k; ++i)
+				leaving_row[i] /= pivot;
+			basic_values[leaving] /= pivot;
+			for (int r = 0; r < k; ++r) {
+				double factor = entering_column[r];
+				if (r == leaving || factor == 0.)
+					continue;
+				double* current_row = basis_inverse.data() + static_cast<size_t>(r) * k;
+				for (int i = 0; i < k; ++i)
+					current_row[i] -= factor * leaving_row[i];
+				basic_values[r] -= factor * basic_values[leaving];
+			}
+			basis[leaving] = entering;
+			++number_of_iterations;
+			if (++number_of_pivots % reinversion_interval == 0)
+				reinvert();
+		}
+
+		// The weights of the vertices are the normalized prices. The rounding errors may give small negative prices, they are replaced by 0.
+		double sum_of_prices = 0.;
+		for (double& price : prices) {
+			price = std::max(price, 0.);
+			sum_of_prices += price;
+		}
+		solution.assign(k + 1, 0.);
+		solution[0] = 1.;
+		for (int i = 1; i < k; ++i)
+			solution[i] = m * prices[i] / sum_of_prices;
+
+		// The value is calculated directly at the point.
+		double value = 0.;
+		bool is_first = true;
+		for (const auto& p : all_linear_functions) {
+			double f = p.get_coef_under_variable(0);
+			for (int i = 1; i < k; ++i)
+				f += p.get_coef_under_variable(i) * solution[i];
+			value = is_first ? f : std::min(value, f);
+			is_first = false;
+		}
+		solution[k] = value;
+		return value;
+	}
+
+	//Returns the solution point of the last problem in the same form as lp_solver_context: x[0] = 1, then x[1], ..., x[n], and the value x[n+1].
+	const std::vector<double>& get_solution() const noexcept {
+		return solution;
+	}
+
+	//Writes the optimal basis of the last problem: the basic rows of G (the indices of the functions in the order of the container)
+	//and the coordinates i of the vertices whose slacks are not basic, i.e. the columns of G where the constraints are tight. There are as many of them as rows.
+	//The basis gives the exact solution without the rounding errors, see exact_lp_certificate.
+	void get_optimal_basis(std::vector<int>& rows, std::vector<int>& coordinates) const {
+		rows.clear();
+		coordinates.clear();
+		std::vector<char> is_slack_basic(num_of_columns, 0);
+		for (int variable : basis) {
+			if (variable < num_of_rows)
+				rows.push_back(variable);
+			else
+				is_slack_basic[variable - num_of_rows] = 1;
+		}
+		std::sort(rows.begin(), rows.end());
+		for (int i = 0; i < num_of_columns; ++i)
+			if (!is_slack_basic[i])
+				coordinates.push_back(i);
+	}
+
+	long long get_number_of_iterations() const noexcept {
+		return number_of_iterations;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*
+ This class runs a separate thread that calls the given function every interval seconds until the object is destroyed.
+ It is used to print the progress of long calculations (see find_worst_diagrams). The function gets the number of seconds passed since the start.
+ If the interval is not positive, no thread is started.
+*/
+
+class periodic_reporter {
+private:
+	std::function<void(double)> report;
+	std::chrono::duration<double> interval;
+	std::chrono::steady_clock::time_point start;
+	std::mutex mutex;
+	std::condition_variable stop_condition;
+	bool is_stopped;
+	std::thread thread;
+
+private:
+	//Technical function. The loop of the thread. The waiting is interrupted as soon as the reporter is stopped.
+	void run() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!stop_condition.wait_for(lock, interval, [this] { return is_stopped; })) {
+			lock.unlock();
+			report(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			lock.lock();
+		}
+	}
+
+public:
+	periodic_reporter(std::function<void(double)> _report, double _interval) :
+		report(std::move(_report)), interval(_interval), start(std::chrono::steady_clock::now()), is_stopped(false) {
+		if (_interval > 0.)
+			thread = std::thread(&periodic_reporter::run, this);
+	}
+
+	periodic_reporter(const periodic_reporter&) = delete;
+	periodic_reporter& operator=(const periodic_reporter&) = delete;
+
+	~periodic_reporter() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			is_stopped = true;
+		}
+		stop_condition.notify_all();
+		if (thread.joinable())
+			thread.join();
+	}
+};
\ No newline at end of file
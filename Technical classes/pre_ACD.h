@@ -2,21 +2,35 @@
 #include <vector>
 
 #include "Technical classes/chord_diagram_base_class.h"
+#include "Technical classes/static_vector.h"
+#include "Technical classes/pre_ACD_in_place.h"
 
 /*
- This class represents preACD.
- It contains implementations of virtual functions from the base class, as well as a function for output.
+ This class represents preACD of length at most max_length.
+ It contains implementations of the functions described in the base class, as well as a function for output.
  Since chords without one end are possible in the case of preACD, we also need a special class for working with them.
 */
 
-class pre_ACD : public chord_diagram_base {
+template<int max_length>
+class pre_ACD : public chord_diagram_base<linear_function<2 * max_length + 1>> {
+public:
+	using function_type = linear_function<2 * max_length + 1>;
+	using turns_type = static_vector<int, 2 * max_length>;
+	using in_place_type = pre_ACD_in_place<max_length>;	// The same diagrams with transformations applied in place. It is used by the brute force functions.
+
+	static constexpr bool is_pre_ACD = true;
+
+	static const char* get_class_name() noexcept {
+		return "preACD";
+	}
+
 private:
 	//Technical class for storing a letter corresponding to a chord and a linear function associated with it.
 	class letter {
 	public:
 		int alpha_number;							//If it is -1, then letter is a part of simple curve J
 		int id;										//Unique id of the letter;
-		linear_function closest_linear_function;	//The linear function associated with the letter
+		function_type closest_linear_function;		//The linear function associated with the letter
 
 	public:
 		letter(letter&&) = default;
@@ -33,14 +47,20 @@ private:
 		}
 	};
 
+	using side_type = static_vector<letter, max_length>;
+
 private:
-	std::vector<letter> lhs;	//List of letters on the left hand side from J (the closest point has the maximal index)
-	std::vector<letter> rhs;	//List of letters on the right hand side from J (the closest point has the maximal index)
+	using base = chord_diagram_base<function_type>;
+	using base::total_increaser;
+	using base::number_of_increases;
+
+	side_type lhs;	//List of letters on the left hand side from J (the closest point has the maximal index)
+	side_type rhs;	//List of letters on the right hand side from J (the closest point has the maximal index)
 
 private:
 	//Technical function. Checks if a letter has a pair. 
 	//If there is, then the function returns a pointer to the side, and the num variable stores the index of the paired letter.
-	std::vector<letter>* find_letter(letter& pair_letter, int& num) noexcept {
+	side_type* find_letter(letter& pair_letter, int& num) noexcept {
 		for (size_t i = 0; i < lhs.size(); ++i) {
 			if ((lhs[i].alpha_number == pair_letter.alpha_number) && (lhs[i].id != pair_letter.id)) {
 				num = i;
@@ -63,7 +83,7 @@ public:
 	pre_ACD& operator=(const pre_ACD&) = default;
 	pre_ACD& operator=(pre_ACD&&) = default;
 
-	pre_ACD(const std::vector<int>& _chords) noexcept : chord_diagram_base(_chords.size()+1){
+	pre_ACD(const std::vector<int>& _chords) noexcept : base(_chords.size()+1){
 		int half_size = _chords.size() / 2;
 		lhs.resize(half_size);
 		rhs.resize(half_size);
@@ -76,8 +96,8 @@ public:
 	//Return vector with all indices where we can apply Transformation II. 
 	//The index is greater than zero for the right hand side element and less than zero otherwise
 	//Notice: the index can not be zero.
-	std::vector<int> get_all_possible_turns() const noexcept override {
-		std::vector<int> indecies;
+	turns_type get_all_possible_turns() const noexcept {
+		turns_type indecies;
 		for (int i = lhs.size() - 1; i > 0; --i) {
 			if (lhs[i].alpha_number == lhs[i - 1].alpha_number)
 				indecies.push_back(-i);
@@ -92,8 +112,8 @@ public:
 	//Use Transformation I to eliminate the chord closest to the basepoint. 
 	//If the function returns false, then there are no letters left on the corresponding side.
 	// is_limit_case shows whether we consider the limit case, i.e. when m->inf (and thus adding one more crossing is insignificant)
-	bool eliminate_from_side(bool is_right, bool is_limit_case) noexcept override {
-		std::vector<letter>& side = is_right ? rhs : lhs;
+	bool eliminate_from_side(bool is_right, bool is_limit_case) noexcept {
+		side_type& side = is_right ? rhs : lhs;
 		//Check if we can eliminate letter
 		if (side.empty())
 			return false;
@@ -107,10 +127,10 @@ public:
 			side[side.size() - 2] += side[side.size() - 1];
 		//Check if there is a paired letter
 		int paired_letter_index = -1;
-		std::vector<letter>* paired_letter_side = find_letter(side[side.size() - 1], paired_letter_index);
+		side_type* paired_letter_side = find_letter(side[side.size() - 1], paired_letter_index);
 		//If there is a paired letter, then delete it
 		if (paired_letter_side != nullptr) {
-			std::vector<letter>& pl_side = *paired_letter_side;
+			side_type& pl_side = *paired_letter_side;
 			//If the paired letter is not the last then increase the linear function corresponding to the next letter
 			if (paired_letter_index > 0) {
 				pl_side[paired_letter_index - 1].closest_linear_function +=
@@ -125,9 +145,9 @@ public:
 	}
 
 	//Use Transformation II to eliminate chord. 
-	bool eliminate_turn(int index) noexcept override {
+	bool eliminate_turn(int index) noexcept {
 		//If index is < 0, then the symbol is on the left hand side
-		std::vector<letter>& side = index > 0 ? rhs : lhs;
+		side_type& side = index > 0 ? rhs : lhs;
 		int ind = std::abs(index);
 		total_increaser += side[ind - 1].closest_linear_function;
 		++number_of_increases;
@@ -141,6 +161,25 @@ public:
 		return true;
 	}
 
+	//Write the canonical encoding of the current state into key. 
+	//The id of a letter is not encoded, since it is used only to distinguish the letter from its pair.
+	void get_state_key(std::vector<int>& key) const {
+		std::vector<int> names;
+		key.clear();
+		key.push_back(number_of_increases);
+		key.push_back(static_cast<int>(lhs.size()));
+		key.push_back(static_cast<int>(rhs.size()));
+		for (const auto& l : lhs)
+			key.push_back(base::get_canonical_name(names, l.alpha_number));
+		for (const auto& l : rhs)
+			key.push_back(base::get_canonical_name(names, l.alpha_number));
+		for (const auto& l : lhs)
+			l.closest_linear_function.append_coefficients(key);
+		for (const auto& l : rhs)
+			l.closest_linear_function.append_coefficients(key);
+		total_increaser.append_coefficients(key);
+	}
+
 	friend std::ostream& operator<<(std::ostream& stream_out, const pre_ACD& str) {
 		for (auto iter = str.lhs.cbegin(); iter != str.lhs.cend(); ++iter)
 			stream_out << iter->alpha_number << " ";
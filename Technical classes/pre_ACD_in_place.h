@@ -0,0 +1,271 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "Technical classes/chord_diagram_base_class.h"
+#include "Technical classes/static_vector.h"
+
+/*
+ This class represents the same preACD as pre_ACD, but the transformations are applied in place and can be reverted by undo().
+ So the recursion in all_linear_functions_in_place uses one object for the whole tree of eliminations instead of a copy for every state.
+
+ Every side is stored as a doubly linked list of letters, from the farthest letter to the closest one (i.e. in the order of indices of pre_ACD).
+ The letters are never moved, the eliminated ones are only unlinked (their own links are kept, so they can be linked back, see undo).
+ partner[] gives the letter with the same chord, so no search is needed.
+ The linear functions are changed only by additions, so undo() subtracts the same functions, which are still stored in the unlinked letters.
+ The results (the increaser and the state keys) coincide with the ones of pre_ACD after the same transformations.
+*/
+
+template<int max_length>
+class pre_ACD_in_place : public chord_diagram_base<linear_function<2 * max_length + 1>> {
+public:
+	using function_type = linear_function<2 * max_length + 1>;
+	using turns_type = static_vector<int, max_length>;	// The closest letters of pairs which can be eliminated by Transformation II.
+
+	static constexpr bool is_pre_ACD = true;
+
+	static const char* get_class_name() noexcept {
+		return "preACD";
+	}
+
+private:
+	using base = chord_diagram_base<function_type>;
+	using base::total_increaser;
+	using base::number_of_increases;
+
+	// The nodes before the farthest and after the closest letters of the left and the right hand sides. The letters are the next nodes.
+	static constexpr int left_head = 0;
+	static constexpr int left_tail = 1;
+	static constexpr int right_head = 2;
+	static constexpr int right_tail = 3;
+	static constexpr int first_letter = 4;
+	static constexpr int max_num_of_nodes = 2 * max_length + 4;
+
+	//Technical class. The record of the undo log, i.e. everything needed to revert one transformation.
+	class elimination_record {
+	public:
+		int removed[2];			// The unlinked letters in order of unlinking (-1 if there is only one).
+		int survivor;			// The letter which absorbs the functions of the removed ones (-1 if there is no such letter).
+		int neighbour;			// For Transformation I, the letter next to the eliminated one (-1 if there is no such letter).
+		bool is_turn;
+		bool is_limit_case;
+	};
+
+	int next[max_num_of_nodes];
+	int prev[max_num_of_nodes];
+	int alpha_number[max_num_of_nodes];
+	int partner[max_num_of_nodes];						// The letter with the same alpha_number, or -1.
+	bool is_on_right[max_num_of_nodes];
+	bool is_linked[max_num_of_nodes];
+	function_type closest_linear_function[max_num_of_nodes];
+	int size_of_side[2];								// The number of letters on the left and on the right hand sides.
+	static_vector<elimination_record, 2 * max_length> undo_log;
+
+private:
+	//Technical functions. Unlink the letter from its side and link it back. Letters must be linked back in the reverse order.
+	void unlink(int node) noexcept {
+		next[prev[node]] = next[node];
+		prev[next[node]] = prev[node];
+		is_linked[node] = false;
+		--size_of_side[is_on_right[node]];
+	}
+
+	void relink(int node) noexcept {
+		next[prev[node]] = node;
+		prev[next[node]] = node;
+		is_linked[node] = true;
+		++size_of_side[is_on_right[node]];
+	}
+
+	//Technical function. Returns true if the node is a letter (and not a head or a tail).
+	static bool is_letter(int node) noexcept {
+		return node >= first_letter;
+	}
+
+	//Technical function. Links the letter to the end of the side.
+	void append(int node, int tail) noexcept {
+		prev[node] = prev[tail];
+		next[node] = tail;
+		next[prev[tail]] = node;
+		prev[tail] = node;
+		is_linked[node] = true;
+	}
+
+public:
+	pre_ACD_in_place(const std::vector<int>& _chords) noexcept : base(_chords.size() + 1) {
+		int half_size = static_cast<int>(_chords.size()) / 2;
+		next[left_head] = left_tail;
+		prev[left_tail] = left_head;
+		next[right_head] = right_tail;
+		prev[right_tail] = right_head;
+		size_of_side[0] = size_of_side[1] = half_size;
+		// The letters of the left hand side are the nodes first_letter, ..., first_letter + half_size - 1, then the letters of the right hand side follow.
+		for (int id_counter = 0; id_counter < 2 * half_size; ++id_counter) {
+			int node = first_letter + id_counter;
+			bool is_right = id_counter >= half_size;
+			alpha_number[node] = is_right ? _chords[3 * half_size - 1 - id_counter] : _chords[id_counter];
+			is_on_right[node] = is_right;
+			partner[node] = -1;
+			closest_linear_function[node] = function_type(1 + id_counter, 1, 2 * half_size + 1);
+			append(node, is_right ? right_tail : left_tail);
+		}
+		for (int node = first_letter; node < first_letter + 2 * half_size; ++node)
+			for (int other = node + 1; other < first_letter + 2 * half_size; ++other)
+				if (alpha_number[node] == alpha_number[other]) {
+					partner[node] = other;
+					partner[other] = node;
+				}
+	}
+
+	//Return the closest letters of all pairs where we can apply Transformation II, in the same order as pre_ACD.
+	turns_type get_all_possible_turns() const noexcept {
+		turns_type results;
+		for (int tail : { left_tail, right_tail })
+			for (int node = prev[tail]; is_letter(node) && is_letter(prev[node]); node = prev[node])
+				if (alpha_number[node] == alpha_number[prev[node]])
+					results.push_back(node);
+		return results;
+	}
+
+	//Use Transformation I to eliminate the letter closest to the basepoint, see pre_ACD.
+	bool eliminate_from_side(bool is_right, bool is_limit_case) noexcept {
+		int last = prev[is_right ? right_tail : left_tail];
+		if (!is_letter(last))
+			return false;
+		elimination_record record;
+		record.is_turn = false;
+		record.is_limit_case = is_limit_case;
+		record.removed[0] = record.removed[1] = -1;
+		record.neighbour = record.survivor = -1;
+
+		const function_type& p = closest_linear_function[last];
+		++number_of_increases;
+		total_increaser += 2 * p;
+		if (!is_limit_case)
+			total_increaser += 1;
+		if (is_letter(prev[last])) {
+			record.neighbour = prev[last];
+			closest_linear_function[record.neighbour] += p;
+		}
+		int paired_letter = partner[last];
+		if (paired_letter != -1 && is_linked[paired_letter]) {
+			if (is_letter(prev[paired_letter])) {
+				record.survivor = prev[paired_letter];
+				closest_linear_function[record.survivor] += closest_linear_function[paired_letter] + 2 * p;
+				if (!is_limit_case)
+					closest_linear_function[record.survivor] += 1;
+			}
+			unlink(paired_letter);
+			record.removed[0] = paired_letter;
+		}
+		unlink(last);
+		record.removed[record.removed[0] == -1 ? 0 : 1] = last;
+		undo_log.push_back(record);
+		return true;
+	}
+
+	//Use Transformation II to eliminate the pair with the given closest letter (see get_all_possible_turns).
+	bool eliminate_turn(int node) noexcept {
+		elimination_record record;
+		record.is_turn = true;
+		record.is_limit_case = false;
+		int farther = prev[node];
+		record.neighbour = -1;
+		record.survivor = is_letter(prev[farther]) ? prev[farther] : -1;
+
+		++number_of_increases;
+		total_increaser += closest_linear_function[farther];
+		if (record.survivor != -1)
+			closest_linear_function[record.survivor] += closest_linear_function[farther] + closest_linear_function[node];
+		unlink(farther);
+		unlink(node);
+
+		record.removed[0] = farther;
+		record.removed[1] = node;
+		undo_log.push_back(record);
+		return true;
+	}
+
+	//Revert the last transformation.
+	void undo() noexcept {
+		const elimination_record& record = undo_log[undo_log.size() - 1];
+		for (int i = 1; i >= 0; --i)
+			if (record.removed[i] != -1)
+				relink(record.removed[i]);
+		if (record.is_turn) {
+			const function_type& farther = closest_linear_function[record.removed[0]];
+			if (record.survivor != -1)
+				closest_linear_function[record.survivor] -= farther + closest_linear_function[record.removed[1]];
+			total_increaser -= farther;
+		}
+		else {
+			// The eliminated letter is the last removed one.
+			int last = record.removed[record.removed[1] == -1 ? 0 : 1];
+			const function_type& p = closest_linear_function[last];
+			if (record.survivor != -1) {
+				closest_linear_function[record.survivor] -= closest_linear_function[record.removed[0]] + 2 * p;
+				if (!record.is_limit_case)
+					closest_linear_function[record.survivor] += -1;
+			}
+			if (record.neighbour != -1)
+				closest_linear_function[record.neighbour] -= p;
+			total_increaser -= 2 * p;
+			if (!record.is_limit_case)
+				total_increaser += -1;
+		}
+		--number_of_increases;
+		undo_log.pop_back();
+	}
+
+	//Write the canonical encoding of the current state into key. It coincides with the one of pre_ACD.
+	void get_state_key(std::vector<int>& key) const {
+		int new_names[2 * max_length + 2];
+		std::fill_n(new_names, 2 * max_length + 2, -1);
+		int number_of_names = 0;
+		key.clear();
+		key.push_back(number_of_increases);
+		key.push_back(size_of_side[0]);
+		key.push_back(size_of_side[1]);
+		for (int head : { left_head, right_head })
+			for (int node = next[head]; is_letter(node); node = next[node]) {
+				if (new_names[alpha_number[node]] == -1)
+					new_names[alpha_number[node]] = number_of_names++;
+				key.push_back(new_names[alpha_number[node]]);
+			}
+		for (int head : { left_head, right_head })
+			for (int node = next[head]; is_letter(node); node = next[node])
+				closest_linear_function[node].append_coefficients(key);
+		total_increaser.append_coefficients(key);
+	}
+
+	//Write the canonical encoding of the residual diagram, i.e. of the current state without the linear functions, into key (see function_set_cache).
+	void get_residual_key(std::vector<int>& key) const {
+		int new_names[2 * max_length + 2];
+		std::fill_n(new_names, 2 * max_length + 2, -1);
+		int number_of_names = 0;
+		key.clear();
+		key.push_back(size_of_side[0]);
+		key.push_back(size_of_side[1]);
+		for (int head : { left_head, right_head })
+			for (int node = next[head]; is_letter(node); node = next[node]) {
+				if (new_names[alpha_number[node]] == -1)
+					new_names[alpha_number[node]] = number_of_names++;
+				key.push_back(new_names[alpha_number[node]]);
+			}
+	}
+
+	//Returns the number of letters left, i.e. the number of linear functions of the residual diagram.
+	int get_number_of_weights() const noexcept {
+		return size_of_side[0] + size_of_side[1];
+	}
+
+	//Exchange the linear functions of the letters (in the order of get_residual_key) and the increaser with the elements of weights.
+	//The size of weights is get_number_of_weights() + 1, and the increaser is the last element.
+	void swap_weights(std::vector<function_type>& weights) noexcept {
+		int i = 0;
+		for (int head : { left_head, right_head })
+			for (int node = next[head]; is_letter(node); node = next[node])
+				std::swap(closest_linear_function[node], weights[i++]);
+		std::swap(total_increaser, weights[i]);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ This class writes the estimates of every considered diagram to a binary file, so that they can be analysed later without repeating the calculation
+ (see results_log_functions.h). Every thread writes its own file, and the records are only appended to it.
+ A record has a fixed size of 40 bytes: the diagram (the vector rhs_lhs) packed into 5 bits per symbol with the number of its symbols,
+ the number of diagrams it represents (e.g. 2 for a diagram and its mirror image, see get_symmetry_orbit_size) and both estimates.
+ The records are collected in a buffer and written when it is full, so the file is written in large blocks.
+*/
+
+class results_log {
+public:
+	static constexpr int max_number_of_symbols = 24;	// Enough for n_max = 12. The symbols of rhs_lhs are not greater than 2 * n_max = 24.
+	static constexpr int bits_per_symbol = 5;
+
+	//Technical class. One record of the file.
+	class record {
+	public:
+		unsigned char packed_diagram[(max_number_of_symbols * bits_per_symbol + 7) / 8];	// The first symbol in the lowest bits.
+		unsigned char number_of_symbols;
+		int multiplicity;
+		double value_8;
+		double value_limit;
+
+	public:
+		void set_diagram(const std::vector<int>& rhs_lhs) noexcept {
+			for (auto& byte : packed_diagram)
+				byte = 0;
+			number_of_symbols = static_cast<unsigned char>(std::min<size_t>(rhs_lhs.size(), max_number_of_symbols));
+			for (int i = 0; i < number_of_symbols; ++i)
+				for (int bit = 0; bit < bits_per_symbol; ++bit)
+					if ((rhs_lhs[i] >> bit) & 1) {
+						int position = i * bits_per_symbol + bit;
+						packed_diagram[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+					}
+		}
+
+		std::vector<int> get_diagram() const {
+			std::vector<int> rhs_lhs(std::min<int>(number_of_symbols, max_number_of_symbols), 0);
+			for (int i = 0; i < static_cast<int>(rhs_lhs.size()); ++i)
+				for (int bit = 0; bit < bits_per_symbol; ++bit) {
+					int position = i * bits_per_symbol + bit;
+					rhs_lhs[i] |= ((packed_diagram[position / 8] >> (position % 8)) & 1) << bit;
+				}
+			return rhs_lhs;
+		}
+	};
+	static_assert(sizeof(record) == 40, "A record of the results log should take 40 bytes");
+	static_assert((1 << bits_per_symbol) > max_number_of_symbols, "The symbols of rhs_lhs should fit into bits_per_symbol bits");
+
+private:
+	static constexpr size_t buffer_size = 4096;		// The number of records written at once.
+
+	std::ofstream file_out;
+	std::vector<record> buffer;
+
+private:
+	//Technical function. Write the buffer to the file.
+	void flush() {
+		file_out.write(reinterpret_cast<const char*>(buffer.data()), sizeof(record) * buffer.size());
+		file_out.flush();
+		buffer.clear();
+	}
+
+public:
+	explicit results_log(const std::string& file_name) : file_out(file_name, std::ios::binary | std::ios::app) {
+		buffer.reserve(buffer_size);
+	}
+
+	results_log(const results_log&) = delete;
+	results_log& operator=(const results_log&) = delete;
+
+	~results_log() {
+		flush();
+	}
+
+	void add(const std::vector<int>& rhs_lhs, double value_8, double value_limit, int multiplicity) {
+		buffer.emplace_back();
+		record& new_record = buffer.back();
+		new_record.set_diagram(rhs_lhs);
+		new_record.multiplicity = multiplicity;
+		new_record.value_8 = value_8;
+		new_record.value_limit = value_limit;
+		if (buffer.size() == buffer_size)
+			flush();
+	}
+
+	//Read all records of the file. Returns false if the file cannot be read (an incomplete last record is ignored).
+	static bool read(const std::string& file_name, std::vector<record>& records) {
+		std::ifstream file_in(file_name, std::ios::binary);
+		if (!file_in)
+			return false;
+		record new_record;
+		while (file_in.read(reinterpret_cast<char*>(&new_record), sizeof(new_record)))
+			records.push_back(new_record);
+		return true;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Technical classes/estimation_result.h"
+
+/*
+ This class represents the results of one shard, i.e. one of the independent runs among which the units of a given length are divided.
+ It is stored in a small text file, so the files written on different machines can be merged on any of them.
+ The file also stores the partition of the units (number_of_shards and shard_boundaries) and the fingerprint of the settings which change the results,
+ so the shards of different partitions or settings are not merged.
+*/
+
+class shard_result {
+public:
+	std::string class_name;		// "ACD" or "preACD".
+	int length = 0;
+	int shard_index = 0;
+	int number_of_shards = 1;
+	std::vector<int> shard_boundaries;	// The boundaries of the shards in units (see estimation_options), empty if the units are dealt in turn.
+	unsigned long long fingerprint = 0;	// See get_fingerprint in estimation_options. It is found with shard_index = 0, so it is the same for all shards.
+	double time = 0.;			// The wall-clock time taken by the shard, in seconds.
+	double cpu_time = 0.;		// The CPU time of the process (i.e. the sum over all threads), in seconds.
+	estimation_result result;
+
+public:
+	friend std::ostream& operator<<(std::ostream& stream_out, const shard_result& shard) {
+		stream_out << std::setprecision(17)
+			<< "class " << shard.class_name << "\n"
+			<< "length " << shard.length << "\n"
+			<< "shard " << shard.shard_index << " " << shard.number_of_shards << "\n"
+			<< "settings " << shard.fingerprint << "\n"
+			<< "boundaries " << shard.shard_boundaries.size();
+		for (int boundary : shard.shard_boundaries)
+			stream_out << " " << boundary;
+		stream_out << "\n"
+			<< "time " << shard.time << " " << shard.cpu_time << "\n"
+			<< shard.result;
+		return stream_out;
+	}
+
+	friend std::istream& operator>>(std::istream& stream_in, shard_result& shard) {
+		std::string name;
+		size_t number_of_boundaries = 0;
+		stream_in >> name >> shard.class_name >> name >> shard.length 
+			>> name >> shard.shard_index >> shard.number_of_shards >> name >> shard.fingerprint >> name >> number_of_boundaries;
+		if (!stream_in || number_of_boundaries > static_cast<size_t>(shard.number_of_shards) + 1) {
+			stream_in.setstate(std::ios::failbit);
+			return stream_in;
+		}
+		shard.shard_boundaries.assign(number_of_boundaries, 0);
+		for (int& boundary : shard.shard_boundaries)
+			stream_in >> boundary;
+		stream_in >> name >> shard.time >> shard.cpu_time >> shard.result;
+		return stream_in;
+	}
+};
\ No newline at end of file
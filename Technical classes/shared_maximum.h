@@ -0,0 +1,27 @@
+#pragma once
+#include <atomic>
+
+/*
+ This class represents a maximum value shared by several threads. It can be updated and read without locks.
+*/
+
+class shared_maximum {
+private:
+	std::atomic<double> value;
+
+public:
+	explicit shared_maximum(double initial_value = -1.) noexcept : value(initial_value) {}
+
+	shared_maximum(const shared_maximum&) = delete;
+	shared_maximum& operator=(const shared_maximum&) = delete;
+
+	double get() const noexcept {
+		return value.load(std::memory_order_relaxed);
+	}
+
+	//Set the value to the maximum of the current value and new_value.
+	void update(double new_value) noexcept {
+		double current = value.load(std::memory_order_relaxed);
+		while (new_value > current && !value.compare_exchange_weak(current, new_value, std::memory_order_relaxed));
+	}
+};
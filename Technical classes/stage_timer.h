@@ -0,0 +1,75 @@
+#pragma once
+#include <chrono>
+#include <ctime>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+/*
+ These classes measure the time spent in one stage of the calculation (e.g. in the LP solver).
+ Both the wall-clock time and the CPU time of the thread are measured, so their difference shows the time the thread was waiting (e.g. for a free core).
+ Every thread measures its own stages, so the sums over all threads are thread-seconds, not the duration of the run.
+*/
+
+//Technical function. It returns the CPU time of the calling thread, in seconds.
+inline double get_thread_cpu_time() noexcept {
+#ifdef _WIN32
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time);
+	auto to_seconds = [](const FILETIME& time) { return (static_cast<unsigned long long>(time.dwHighDateTime) << 32 | time.dwLowDateTime) * 1e-7; };
+	return to_seconds(kernel_time) + to_seconds(user_time);
+#else
+	timespec time;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
+
+class stage_time {
+public:
+	double wall_time = 0.;		// In seconds.
+	double cpu_time = 0.;
+
+public:
+	stage_time& operator+=(const stage_time& other) noexcept {
+		wall_time += other.wall_time;
+		cpu_time += other.cpu_time;
+		return *this;
+	}
+
+	stage_time& operator-=(const stage_time& other) noexcept {
+		wall_time -= other.wall_time;
+		cpu_time -= other.cpu_time;
+		return *this;
+	}
+};
+
+// This class adds the time from its construction to its destruction to the given stage_time. If it is null, nothing is measured.
+class stage_timer {
+private:
+	stage_time* time;
+	std::chrono::steady_clock::time_point start_wall_time;
+	double start_cpu_time;
+
+public:
+	explicit stage_timer(stage_time* _time) noexcept : time(_time), start_cpu_time(0.) {
+		if (time != nullptr) {
+			start_wall_time = std::chrono::steady_clock::now();
+			start_cpu_time = get_thread_cpu_time();
+		}
+	}
+
+	stage_timer(const stage_timer&) = delete;
+	stage_timer& operator=(const stage_timer&) = delete;
+
+	~stage_timer() {
+		if (time != nullptr) {
+			time->cpu_time += get_thread_cpu_time() - start_cpu_time;
+			time->wall_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_wall_time).count();
+		}
+	}
+};
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+/*
+ This class represents a vector with a fixed capacity, stored inside the object (without dynamic memory).
+ It is used by the chord diagrams, whose sizes are bounded by the length known at compile time.
+ Only trivially copyable elements are allowed, so the elements are copied and moved inside the vector by memcpy and memmove,
+ and only the used part of the storage is copied.
+*/
+
+template<class value_type, int capacity>
+class static_vector {
+	static_assert(std::is_trivially_copyable<value_type>::value, "static_vector supports only trivially copyable elements");
+	static_assert(capacity > 0, "The capacity of static_vector should be positive");
+
+public:
+	using iterator = value_type*;
+	using const_iterator = const value_type*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+	alignas(value_type) unsigned char storage[sizeof(value_type) * capacity];
+	int current_size;
+
+public:
+	static_vector() noexcept : current_size(0) {}
+
+	static_vector(const static_vector& other) noexcept : current_size(other.current_size) {
+		std::memcpy(storage, other.storage, sizeof(value_type) * current_size);
+	}
+
+	static_vector& operator=(const static_vector& other) noexcept {
+		if (this != &other) {
+			current_size = other.current_size;
+			std::memcpy(storage, other.storage, sizeof(value_type) * current_size);
+		}
+		return *this;
+	}
+
+	value_type* data() noexcept {
+		return reinterpret_cast<value_type*>(storage);
+	}
+
+	const value_type* data() const noexcept {
+		return reinterpret_cast<const value_type*>(storage);
+	}
+
+	int size() const noexcept {
+		return current_size;
+	}
+
+	bool empty() const noexcept {
+		return current_size == 0;
+	}
+
+	value_type& operator[](int i) noexcept {
+		return data()[i];
+	}
+
+	const value_type& operator[](int i) const noexcept {
+		return data()[i];
+	}
+
+	void push_back(const value_type& value) noexcept {
+		new (data() + current_size) value_type(value);
+		++current_size;
+	}
+
+	void pop_back() noexcept {
+		--current_size;
+	}
+
+	void clear() noexcept {
+		current_size = 0;
+	}
+
+	//New elements are value-initialized.
+	void resize(int new_size) noexcept {
+		for (int i = current_size; i < new_size; ++i)
+			new (data() + i) value_type();
+		current_size = new_size;
+	}
+
+	iterator erase(const_iterator position) noexcept {
+		return erase(position, std::next(position));
+	}
+
+	iterator erase(const_iterator first, const_iterator last) noexcept {
+		iterator destination = begin() + (first - cbegin());
+		std::memmove(static_cast<void*>(destination), static_cast<const void*>(last), sizeof(value_type) * (cend() - last));
+		current_size -= static_cast<int>(last - first);
+		return destination;
+	}
+
+	iterator begin() noexcept {
+		return data();
+	}
+
+	iterator end() noexcept {
+		return data() + current_size;
+	}
+
+	const_iterator begin() const noexcept {
+		return data();
+	}
+
+	const_iterator end() const noexcept {
+		return data() + current_size;
+	}
+
+	const_iterator cbegin() const noexcept {
+		return data();
+	}
+
+	const_iterator cend() const noexcept {
+		return data() + current_size;
+	}
+
+	reverse_iterator rbegin() noexcept {
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend() noexcept {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator crbegin() const noexcept {
+		return const_reverse_iterator(cend());
+	}
+
+	const_reverse_iterator crend() const noexcept {
+		return const_reverse_iterator(cbegin());
+	}
+};
\ No newline at end of file
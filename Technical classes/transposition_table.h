@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "Technical classes/estimation_statistics.h"
+
+/*
+ This class represents a transposition table for the elimination states of a single (pre)ACD.
+ Different orders of Transformations I and II often lead to the same residual (pre)ACD with the same increaser,
+ and the set of linear functions obtained below such a state does not depend on the way it was reached.
+ The table stores canonical encodings of the expanded states (see get_state_key in ACD and pre_ACD), so that every state is expanded only once.
+
+ The table is a hash table with open addressing, and all keys are stored one after another in a single buffer.
+ clear() does not free the memory: the buffer is emptied, and the slots are invalidated by increasing the generation number.
+ So a table reused for many diagrams (see get_thread_transposition_table) allocates memory only when it grows beyond its previous size.
+*/
+
+class transposition_table {
+private:
+	//Technical class. A slot of the hash table. It is occupied if its generation is the current one.
+	class slot {
+	public:
+		size_t hash = 0;
+		int offset = 0;					// The position of the key in key_storage.
+		int length = 0;
+		unsigned generation = 0;
+	};
+
+	//Technical function. FNV-1a hash of the state encoding.
+	static size_t get_hash(const std::vector<int>& key) noexcept {
+		unsigned long long hash = 14695981039346656037ull;
+		for (int value : key) {
+			hash ^= static_cast<unsigned int>(value);
+			hash *= 1099511628211ull;
+		}
+		return static_cast<size_t>(hash);
+	}
+
+	static constexpr size_t initial_number_of_slots = 1024;
+
+private:
+	std::vector<int> key_storage;
+	std::vector<slot> slots;			// The number of slots is a power of two, and at most half of them are occupied.
+	unsigned generation;
+	size_t number_of_keys;
+	long long number_of_lookups;
+	long long number_of_hits;
+
+private:
+	//Technical function. Doubles the number of slots and moves the keys of the current generation.
+	void grow() {
+		std::vector<slot> old_slots(slots.empty() ? initial_number_of_slots : 2 * slots.size());
+		old_slots.swap(slots);
+		size_t mask = slots.size() - 1;
+		for (const auto& s : old_slots) {
+			if (s.generation != generation)
+				continue;
+			size_t i = s.hash & mask;
+			while (slots[i].generation == generation)
+				i = (i + 1) & mask;
+			slots[i] = s;
+		}
+	}
+
+public:
+	transposition_table() noexcept : generation(1), number_of_keys(0), number_of_lookups(0), number_of_hits(0) {}
+
+	//Add the state to the table. Returns false if the state has already been there, i.e. its subtree can be skipped.
+	bool insert(const std::vector<int>& key) {
+		++number_of_lookups;
+		if (2 * (number_of_keys + 1) > slots.size())
+			grow();
+		size_t hash = get_hash(key);
+		size_t mask = slots.size() - 1;
+		size_t i = hash & mask;
+		for (; slots[i].generation == generation; i = (i + 1) & mask) {
+			const slot& s = slots[i];
+			if (s.hash == hash && s.length == static_cast<int>(key.size()) && std::equal(key.begin(), key.end(), key_storage.begin() + s.offset)) {
+				++number_of_hits;
+				return false;
+			}
+		}
+		slots[i].hash = hash;
+		slots[i].offset = static_cast<int>(key_storage.size());
+		slots[i].length = static_cast<int>(key.size());
+		slots[i].generation = generation;
+		key_storage.insert(key_storage.end(), key.begin(), key.end());
+		++number_of_keys;
+		return true;
+	}
+
+	//Remove all states, but keep the memory.
+	void clear() noexcept {
+		key_storage.clear();
+		number_of_keys = 0;
+		number_of_lookups = 0;
+		number_of_hits = 0;
+		if (++generation == 0) {
+			// After the overflow old slots could look occupied, so they are reset.
+			std::fill(slots.begin(), slots.end(), slot());
+			generation = 1;
+		}
+	}
+
+	//Returns the number of bytes allocated by the table. It is kept between diagrams, so it is the largest size needed so far.
+	size_t get_memory_usage() const noexcept {
+		return key_storage.capacity() * sizeof(int) + slots.capacity() * sizeof(slot);
+	}
+
+	//Add the counters of the table to the statistics.
+	void add_statistics(estimation_statistics& stat) const noexcept {
+		stat.number_of_states += number_of_lookups;
+		stat.number_of_repeated_states += number_of_hits;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ This class represents a simple work-stealing thread pool.
+ Every worker owns a queue of tasks. A worker takes tasks from the back of its own queue (so it goes deep into its subtree first),
+ and when the queue is empty it steals a task from the front of another queue (these are the oldest, and thus usually the largest, tasks).
+ A task may add new tasks to the pool while it is processed, e.g. when it decides to split its subtree because some worker is idle.
+*/
+
+template<class task_type>
+class work_stealing_pool {
+private:
+	//Technical class. Queue of tasks owned by one of the workers.
+	class worker_queue {
+	public:
+		std::mutex mutex;
+		std::deque<task_type> tasks;
+	};
+
+private:
+	std::vector<std::unique_ptr<worker_queue>> queues;
+	std::atomic<long long> number_of_pending_tasks;	// Tasks that have been added, but not yet finished.
+	std::atomic<int> number_of_idle_workers;		// Workers that are looking for a task right now.
+
+private:
+	//Technical function. Takes a task from the own queue or steals it from another one.
+	bool take_task(int worker, task_type& task) {
+		{
+			worker_queue& own = *queues[worker];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.tasks.empty()) {
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+		for (size_t shift = 1; shift < queues.size(); ++shift) {
+			worker_queue& victim = *queues[(worker + shift) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty()) {
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	explicit work_stealing_pool(int number_of_threads) : number_of_pending_tasks(0), number_of_idle_workers(0) {
+		if (number_of_threads < 1)
+			number_of_threads = 1;
+		for (int i = 0; i < number_of_threads; ++i)
+			queues.emplace_back(new worker_queue());
+	}
+
+	work_stealing_pool(const work_stealing_pool&) = delete;
+	work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+	int get_number_of_threads() const noexcept {
+		return static_cast<int>(queues.size());
+	}
+
+	//Returns true if some worker has nothing to do, i.e. it is worth splitting the current task.
+	bool is_hungry() const noexcept {
+		return number_of_idle_workers.load(std::memory_order_relaxed) > 0;
+	}
+
+	//Add a task to the queue of the given worker. It can be called both before run() and from inside a task.
+	void push(int worker, task_type task) {
+		number_of_pending_tasks.fetch_add(1);
+		worker_queue& own = *queues[worker % queues.size()];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		own.tasks.push_back(std::move(task));
+	}
+
+	//Process all the tasks. The function process(worker, task) is called for every task, where worker is the index of the thread.
+	//The function returns when all tasks (including the ones added during the processing) are finished.
+	template<class function_type>
+	void run(function_type process) {
+		auto worker_loop = [this, &process](int worker) {
+			task_type task;
+			bool is_idle = false;
+			while (true) {
+				if (take_task(worker, task)) {
+					if (is_idle) {
+						number_of_idle_workers.fetch_sub(1);
+						is_idle = false;
+					}
+					process(worker, task);
+					number_of_pending_tasks.fetch_sub(1);
+					continue;
+				}
+				if (number_of_pending_tasks.load() == 0)
+					break;
+				if (!is_idle) {
+					number_of_idle_workers.fetch_add(1);
+					is_idle = true;
+				}
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+			if (is_idle)
+				number_of_idle_workers.fetch_sub(1);
+		};
+
+		std::vector<std::thread> threads;
+		for (int i = 1; i < get_number_of_threads(); ++i)
+			threads.emplace_back(worker_loop, i);
+		worker_loop(0);
+		for (auto& thread : threads)
+			thread.join();
+	}
+};
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ This class represents the predicted cost of the calculation for one length (see plan_workload in planning_functions.h): the number of diagrams,
+ the CPU time and the memory, all estimated by random descents through the tree of diagrams, and the division of the units of the tree
+ (see collect_units) into parts of equal predicted cost. The parts are ranges of consecutive units, i.e. of consecutive prefixes,
+ and they can be given to independent runs as shard_boundaries in estimation_options.
+*/
+
+class workload_plan {
+public:
+	std::string class_name;
+	int length = 0;
+	long long number_of_descents = 0;
+	double number_of_diagrams = 0.;				// The predicted number of diagrams.
+	double number_of_diagrams_error = 0.;		// The standard error of the prediction.
+	double cpu_time = 0.;						// The predicted CPU time of the whole calculation (on one core), in seconds.
+	double cpu_time_error = 0.;
+	double memory_per_thread = 0.;				// The largest memory of the containers of a thread (the transposition table, the sets of functions 
+												// and the LP) among the sampled diagrams, in bytes. It is a lower bound for the peak.
+	double sampling_time = 0.;					// The time of the planning itself, in seconds.
+
+	int split_depth = 0;
+	std::vector<double> unit_costs;				// The predicted CPU time of every unit, in seconds.
+	std::vector<int> part_boundaries;			// The part p consists of the units part_boundaries[p], ..., part_boundaries[p + 1] - 1.
+	std::vector<double> part_costs;				// The predicted CPU time of every part.
+	std::vector<std::vector<int>> part_prefixes;	// The prefix of the first unit of every part.
+
+public:
+	friend std::ostream& operator<<(std::ostream& stream_out, const workload_plan& plan) {
+		stream_out << std::fixed << std::setprecision(0)
+			<< "Plan for " << plan.class_name << " of length " << plan.length << " (" << plan.number_of_descents << " random descents, " 
+			<< std::setprecision(2) << plan.sampling_time << " sec.): " << std::setprecision(0)
+			<< plan.number_of_diagrams << " +- " << plan.number_of_diagrams_error << " diagrams, " << std::setprecision(4)
+			<< plan.cpu_time / 3600. << " +- " << plan.cpu_time_error / 3600. << " CPU-hours, " << std::setprecision(1)
+			<< plan.memory_per_thread / 1048576. << " MB per thread\n";
+		for (size_t p = 0; p < plan.part_costs.size(); ++p) {
+			stream_out << "  part " << p << ": units " << plan.part_boundaries[p] << "-" << plan.part_boundaries[p + 1] - 1 << ", " 
+				<< std::setprecision(4) << plan.part_costs[p] / 3600. << " CPU-hours, starting with";
+			for (int c : plan.part_prefixes[p])
+				stream_out << " " << c;
+			stream_out << "\n";
+		}
+		return stream_out;
+	}
+};
\ No newline at end of file
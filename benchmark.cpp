@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "benchmark_functions.h"
+
+// The allocation functions are replaced to count the allocations, see benchmark_function_storage. All forms are replaced
+// (single objects and arrays, sized, nothrow and aligned), so every allocation is counted and freed by the matching function.
+
+// Technical function. The allocation used by all forms of operator new. It returns nullptr if there is no memory.
+void* allocate_counted(size_t size) noexcept {
+	++number_of_allocations;
+	number_of_allocated_bytes += size;
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(size_t size) {
+	if (void* p = allocate_counted(size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return allocate_counted(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return allocate_counted(size);
+}
+
+// Technical function. The deallocation used by all forms of operator delete. It is not inlined, otherwise the compiler sees free applied
+// to the result of operator new in the callers and warns about the mismatch (-Wmismatched-new-delete).
+#ifdef _MSC_VER
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+void deallocate_counted(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p) noexcept {
+	deallocate_counted(p);
+}
+
+void operator delete[](void* p) noexcept {
+	deallocate_counted(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	deallocate_counted(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	deallocate_counted(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	deallocate_counted(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	deallocate_counted(p);
+}
+
+#ifdef __cpp_aligned_new
+// Technical functions. The aligned allocation used by the aligned forms of operator new and the matching deallocation.
+void* allocate_counted(size_t size, std::align_val_t alignment) noexcept {
+	++number_of_allocations;
+	number_of_allocated_bytes += size;
+#ifdef _WIN32
+	return _aligned_malloc(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+#else
+	void* p = nullptr;
+	return posix_memalign(&p, static_cast<size_t>(alignment), size == 0 ? 1 : size) == 0 ? p : nullptr;
+#endif
+}
+
+#ifdef _MSC_VER
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+void deallocate_aligned(void* p) noexcept {
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	if (void* p = allocate_counted(size, alignment))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return allocate_counted(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return allocate_counted(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	deallocate_aligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+	deallocate_aligned(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+	deallocate_aligned(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+	deallocate_aligned(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	deallocate_aligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	deallocate_aligned(p);
+}
+#endif
+
+// This program measures the performance of different parts of the calculation on fixed workloads. See benchmark_functions.h for details.
+// The maximal length of the full calculation can be given as the argument (it is 7 by default). The program returns 1 if some results 
+// differ from the reference values in "Files with numbers".
+int main(int argc, char* argv[]) {
+	int max_length = argc > 1 ? std::atoi(argv[1]) : 7;
+	bool is_correct = benchmark_enumeration<pre_ACD>(std::cout, max_length, "Files with numbers//the_output_1-9(pre_ACD).txt");
+	// The values of C_{n, 8} stored for ACD were obtained by an earlier version, so the ones computed now are pinned for the lengths 1, ..., 7.
+	const std::vector<double> ACD_values_8 = { 1.5625, 3.25, 4.375, 6.4, 11.125, 14.5, 20.125 };
+	is_correct = benchmark_enumeration<ACD>(std::cout, max_length, "Files with numbers//the_output_1-9(ACD).txt", ACD_values_8) && is_correct;
+	is_correct = benchmark_verification<pre_ACD>(std::cout, std::min(max_length, 6), 1000) && is_correct;
+	is_correct = benchmark_verification<ACD>(std::cout, std::min(max_length, 7), 1000) && is_correct;
+	is_correct = benchmark_planner<pre_ACD>(std::cout, 9, max_length, 4, "Files with numbers//the_output_1-9(pre_ACD).txt") && is_correct;
+	is_correct = benchmark_planner<ACD>(std::cout, 9, max_length, 4, "Files with numbers//the_output_1-9(ACD).txt") && is_correct;
+	is_correct = benchmark_diagram_corpus<pre_ACD>(std::cout, max_length) && is_correct;
+	is_correct = benchmark_diagram_corpus<ACD>(std::cout, max_length) && is_correct;
+	is_correct = benchmark_shards<pre_ACD>(std::cout, max_length, 3) && is_correct;
+	is_correct = benchmark_shards<ACD>(std::cout, max_length, 3) && is_correct;
+	is_correct = benchmark_results_log<pre_ACD>(std::cout, std::min(max_length, 6), 2) && is_correct;
+	is_correct = benchmark_results_log<ACD>(std::cout, std::min(max_length, 7), 2) && is_correct;
+	is_correct = benchmark_results_log_records<pre_ACD<9>>(std::cout, 9, 10000) && is_correct;
+	is_correct = benchmark_results_log_records<pre_ACD<12>>(std::cout, 12, 10000) && is_correct;
+
+	benchmark_linear_function<5>(std::cout);
+	benchmark_linear_function<10>(std::cout);
+	constexpr size_t number_of_diagrams = 10000;
+	is_correct = benchmark_hard_diagrams<pre_ACD<7>>(std::cout, 7, number_of_diagrams, 100) && is_correct;
+	is_correct = benchmark_hard_diagrams<ACD<7>>(std::cout, 7, number_of_diagrams, 100) && is_correct;
+	is_correct = benchmark_hard_diagrams<pre_ACD<8>>(std::cout, 8, number_of_diagrams, 100) && is_correct;
+	is_correct = benchmark_hard_diagrams<ACD<8>>(std::cout, 8, number_of_diagrams, 100) && is_correct;
+	is_correct = benchmark_shared_elimination<pre_ACD<10>>(std::cout, 10, 300, 2, 4, 5) && is_correct;
+	is_correct = benchmark_shared_elimination<ACD<10>>(std::cout, 10, 300, 2, 4, 5) && is_correct;
+	benchmark_function_storage<pre_ACD<7>>(std::cout, 7, number_of_diagrams);
+	benchmark_function_storage<ACD<7>>(std::cout, 7, number_of_diagrams);
+	benchmark_elimination<pre_ACD<7>>(std::cout, 7, number_of_diagrams);
+	benchmark_elimination<ACD<7>>(std::cout, 7, number_of_diagrams);
+	is_correct = benchmark_function_cache<pre_ACD<7>>(std::cout, 7, number_of_diagrams, 10) && is_correct;
+	is_correct = benchmark_function_cache<ACD<7>>(std::cout, 7, number_of_diagrams, 12) && is_correct;
+	is_correct = benchmark_function_cache<pre_ACD<8>>(std::cout, 8, number_of_diagrams, 10) && is_correct;
+	is_correct = benchmark_lp_solver<pre_ACD<7>>(std::cout, 7, number_of_diagrams) && is_correct;
+	is_correct = benchmark_lp_solver<ACD<7>>(std::cout, 7, number_of_diagrams) && is_correct;
+	is_correct = benchmark_lp_solver<pre_ACD<8>>(std::cout, 8, number_of_diagrams) && is_correct;
+	is_correct = benchmark_lp_solver<ACD<8>>(std::cout, 8, number_of_diagrams) && is_correct;
+	is_correct = benchmark_row_generation<pre_ACD<7>>(std::cout, 7, number_of_diagrams) && is_correct;
+	is_correct = benchmark_row_generation<ACD<7>>(std::cout, 7, number_of_diagrams) && is_correct;
+	is_correct = benchmark_row_generation<pre_ACD<8>>(std::cout, 8, number_of_diagrams) && is_correct;
+	is_correct = benchmark_row_generation<ACD<8>>(std::cout, 8, number_of_diagrams) && is_correct;
+	is_correct = benchmark_certification<pre_ACD<7>>(std::cout, 7, number_of_diagrams) && is_correct;
+	is_correct = benchmark_certification<ACD<7>>(std::cout, 7, number_of_diagrams) && is_correct;
+	is_correct = benchmark_certification<pre_ACD<8>>(std::cout, 8, number_of_diagrams) && is_correct;
+	is_correct = benchmark_certification<ACD<8>>(std::cout, 8, number_of_diagrams) && is_correct;
+	const std::vector<double> curve_sizes = { 1., 2., 4., 6., 8., 10., 12., 16., 32., 64. };
+	is_correct = benchmark_curve_sizes<pre_ACD<7>>(std::cout, 7, number_of_diagrams, curve_sizes) && is_correct;
+	is_correct = benchmark_curve_sizes<ACD<8>>(std::cout, 8, number_of_diagrams, curve_sizes) && is_correct;
+	return is_correct ? 0 : 1;
+}
\ No newline at end of file
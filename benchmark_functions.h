@@ -0,0 +1,1081 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "brute_force_functions.h"
+#include "planning_functions.h"
+#include "results_log_functions.h"
+#include "shard_functions.h"
+
+/*
+This file contains functions that measure the performance of different parts of the calculation. 
+They use fixed workloads (e.g. the first diagrams of a given length in the order of walk_trough_all_diagrams), so the results of different versions can be compared.
+*/
+
+// The number of calls of operator new and the number of bytes allocated by them. They are counted only if operator new is replaced (see benchmark.cpp).
+std::atomic<long long> number_of_allocations(0);
+std::atomic<long long> number_of_allocated_bytes(0);
+
+// Technical function. It returns the peak resident set size of the process, in megabytes.
+double get_peak_memory_usage() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.PeakWorkingSetSize / 1048576.;
+#else
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024.;		// It is given in kilobytes.
+#endif
+}
+
+// Technical function. It returns the time passed since start, in seconds.
+double get_seconds_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+//Technical class. The scalar implementation of the operations of linear_function (as they were before the vectorization), used as a baseline.
+template<int max_num_of_variables>
+class scalar_linear_function {
+public:
+	int variable_and_coef[max_num_of_variables];
+	int actual_num_of_variables;
+
+	scalar_linear_function& operator*=(int mult) noexcept {
+		for (int i = 0; i < actual_num_of_variables; ++i)
+			variable_and_coef[i] *= mult;
+		return *this;
+	}
+
+	scalar_linear_function& operator+=(const scalar_linear_function& p) noexcept {
+		for (int i = 0; i < actual_num_of_variables; ++i)
+			variable_and_coef[i] += p.variable_and_coef[i];
+		return *this;
+	}
+
+	bool operator==(const scalar_linear_function& _p) const noexcept {
+		for (int i = 0; i < actual_num_of_variables; ++i)
+			if (variable_and_coef[i] != _p.variable_and_coef[i])
+				return false;
+		return true;
+	}
+
+	bool is_dominated_by(const scalar_linear_function& p) const noexcept {
+		for (int i = 0; i < actual_num_of_variables; ++i)
+			if (variable_and_coef[i] < p.variable_and_coef[i])
+				return false;
+		return true;
+	}
+
+	bool operator<(const scalar_linear_function& _p) const noexcept {
+		for (int i = 0; i < actual_num_of_variables - 1; ++i) {
+			if (variable_and_coef[i] < _p.variable_and_coef[i])
+				return true;
+			if (variable_and_coef[i] > _p.variable_and_coef[i])
+				return false;
+		}
+		return variable_and_coef[actual_num_of_variables - 1] < _p.variable_and_coef[actual_num_of_variables - 1];
+	}
+};
+
+// Technical function. It applies the operation to all pairs of consecutive functions number_of_rounds times and prints the time per operation.
+// The sum of the results is returned, so that the compiler cannot drop the calculation.
+template<class function_type, class operation_type>
+long long time_operation(std::ostream& stream_out, const char* name, std::vector<function_type> functions, int number_of_rounds, operation_type operation) {
+	long long checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < number_of_rounds; ++round)
+		for (size_t i = 0; i + 1 < functions.size(); ++i)
+			checksum += operation(functions[i], functions[i + 1]);
+	double time = get_seconds_since(start);
+	stream_out << " " << name << " " << 1e9 * time / (static_cast<double>(number_of_rounds) * (functions.size() - 1)) << " ns";
+	return checksum;
+}
+
+// This function compares the time of the operations of linear_function with the scalar implementation (see scalar_linear_function).
+// The sum is computed in a copy of the function (in both cases), so that the coefficients do not grow.
+// The functions have the number of variables used for ACD of the given length. Every function differs from the previous one in at most
+// one coefficient, so the comparisons have to look through long common prefixes, as it happens for the functions of the same diagram.
+// The results of both implementations must coincide.
+template<int length>
+void benchmark_linear_function(std::ostream& stream_out, int number_of_functions = 1000, int number_of_rounds = 2000) {
+	constexpr int num_of_variables = 2 * length + 2;
+	using linear_function = ::linear_function<num_of_variables>;
+	using scalar_linear_function = ::scalar_linear_function<num_of_variables>;
+	std::mt19937 generator(2024);
+	std::uniform_int_distribution<int> coefficient(0, 2);
+	std::uniform_int_distribution<int> variable(0, num_of_variables - 1);
+	std::vector<linear_function> functions;
+	std::vector<scalar_linear_function> scalar_functions;
+	scalar_linear_function g;
+	g.actual_num_of_variables = num_of_variables;
+	for (int i = 0; i < num_of_variables; ++i)
+		g.variable_and_coef[i] = coefficient(generator);
+	for (int j = 0; j < number_of_functions; ++j) {
+		g.variable_and_coef[variable(generator)] = coefficient(generator);
+		linear_function f(0, 0, num_of_variables);
+		for (int i = 0; i < num_of_variables; ++i)
+			f += linear_function(i, g.variable_and_coef[i], num_of_variables);
+		functions.push_back(f);
+		scalar_functions.push_back(g);
+	}
+
+	stream_out << std::fixed << std::setprecision(2);
+	long long vector_checksums[5], scalar_checksums[5];
+	stream_out << "linear_function, " << num_of_variables << " variables, vectorized:";
+	vector_checksums[0] = time_operation(stream_out, "+=", functions, number_of_rounds, [](linear_function& f, const linear_function& g) { linear_function h = f; h += g; return h.get_coef_under_variable(0); });
+	vector_checksums[1] = time_operation(stream_out, "*=", functions, number_of_rounds, [](linear_function& f, const linear_function&) { f *= -1; return f.get_coef_under_variable(0); });
+	vector_checksums[2] = time_operation(stream_out, "==", functions, number_of_rounds, [](linear_function& f, const linear_function& g) { return f == g; });
+	vector_checksums[3] = time_operation(stream_out, "<", functions, number_of_rounds, [](linear_function& f, const linear_function& g) { return f < g; });
+	vector_checksums[4] = time_operation(stream_out, "dominance", functions, number_of_rounds, [](linear_function& f, const linear_function& g) { return f.is_dominated_by(g); });
+	stream_out << "\nlinear_function, " << num_of_variables << " variables, scalar:    ";
+	scalar_checksums[0] = time_operation(stream_out, "+=", scalar_functions, number_of_rounds, [](scalar_linear_function& f, const scalar_linear_function& g) { scalar_linear_function h = f; h += g; return h.variable_and_coef[0]; });
+	scalar_checksums[1] = time_operation(stream_out, "*=", scalar_functions, number_of_rounds, [](scalar_linear_function& f, const scalar_linear_function&) { f *= -1; return f.variable_and_coef[0]; });
+	scalar_checksums[2] = time_operation(stream_out, "==", scalar_functions, number_of_rounds, [](scalar_linear_function& f, const scalar_linear_function& g) { return f == g; });
+	scalar_checksums[3] = time_operation(stream_out, "<", scalar_functions, number_of_rounds, [](scalar_linear_function& f, const scalar_linear_function& g) { return f < g; });
+	scalar_checksums[4] = time_operation(stream_out, "dominance", scalar_functions, number_of_rounds, [](scalar_linear_function& f, const scalar_linear_function& g) { return f.is_dominated_by(g); });
+	stream_out << "\n" << (std::equal(vector_checksums, vector_checksums + 5, scalar_checksums) ? "The results coincide." : "ERROR: the results differ!") << std::endl;
+}
+
+// Technical function. The same as collect_diagrams, but every prefix is checked and extended by not_interesting and get_possible_values, 
+// which rescan the whole prefix (as the enumeration did before diagram_prefix). It is used as a reference in benchmark_enumeration.
+template<class chord_like_type>
+void collect_diagrams_by_rescanning(std::vector<int>& rhs_lhs, std::vector<std::vector<int>>& diagrams, int length, int new_v) {
+	rhs_lhs.push_back(new_v);
+	if (!not_interesting<chord_like_type>(rhs_lhs, length)) {
+		if (rhs_lhs.size() == static_cast<size_t>(2 * length))
+			diagrams.push_back(rhs_lhs);
+		else
+			for (const auto& c : get_possible_values<chord_like_type>(rhs_lhs, length))
+				collect_diagrams_by_rescanning<chord_like_type>(rhs_lhs, diagrams, length, c);
+	}
+	rhs_lhs.pop_back();
+}
+
+// Technical function. It returns the sets of linear functions of the given diagrams, i.e. the LPs solved for them.
+template<class chord_like_type>
+std::vector<linear_function_front<typename chord_like_type::function_type>> record_function_sets(const std::vector<std::vector<int>>& diagrams, 
+	int length, bool is_limit_case) {
+	std::vector<linear_function_front<typename chord_like_type::function_type>> function_sets(diagrams.size());
+	for (size_t i = 0; i < diagrams.size(); ++i) {
+		transposition_table visited_states;
+		all_linear_functions_chord_diagram(chord_like_type(diagrams[i]), function_sets[i], length, is_limit_case, visited_states);
+	}
+	return function_sets;
+}
+
+// This function compares the time of the traversal of all eliminations (both cases, m = 8 and the limit case) for the first diagrams of the given length:
+// all_linear_functions_chord_diagram copies the diagram for every state, all_linear_functions_in_place applies and reverts the transformations in place, 
+// and all_linear_functions_for_both_cases traverses the eliminations in place once for both cases.
+// The number of elimination states per second is the one of the in place traversal.
+template<class chord_like_type>
+void benchmark_elimination(std::ostream& stream_out, int length, const std::vector<std::vector<int>>& diagrams) {
+	using function_front = linear_function_front<typename chord_like_type::function_type>;
+	size_t number_of_rows = 0, number_of_reference_rows = 0;
+	estimation_statistics stat;
+
+	auto start = std::chrono::steady_clock::now();
+	for (const auto& rhs_lhs : diagrams)
+		for (bool is_limit_case : { false, true }) {
+			function_front results;
+			transposition_table visited_states;
+			all_linear_functions_chord_diagram(chord_like_type(rhs_lhs), results, length, is_limit_case, visited_states);
+			number_of_reference_rows += results.size();
+		}
+	double reference_time = get_seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	std::vector<int> state_key;
+	for (const auto& rhs_lhs : diagrams) {
+		typename chord_like_type::in_place_type diagram(rhs_lhs);
+		for (bool is_limit_case : { false, true }) {
+			function_front results;
+			transposition_table visited_states;
+			all_linear_functions_in_place(diagram, results, length, is_limit_case, visited_states, state_key);
+			visited_states.add_statistics(stat);
+			number_of_rows += results.size();
+		}
+	}
+	double in_place_time = get_seconds_since(start);
+
+	size_t number_of_combined_rows = 0;
+	estimation_statistics combined_stat;
+	start = std::chrono::steady_clock::now();
+	for (const auto& rhs_lhs : diagrams) {
+		typename chord_like_type::in_place_type diagram(rhs_lhs);
+		all_linear_functions_for_both_cases(diagram, length, combined_stat);
+		for (bool is_limit_case : { false, true })
+			number_of_combined_rows += get_thread_function_front<typename chord_like_type::function_type>(is_limit_case).size();
+	}
+	double combined_time = get_seconds_since(start);
+
+	size_t number_of_diagrams = std::max<size_t>(1, diagrams.size());
+	stream_out
+		<< "Elimination, " << get_class_name<chord_like_type>() << " of length " << length << ", " << diagrams.size() << " diagrams: "
+		<< std::fixed << std::setprecision(2)
+		<< "copies " << 1e6 * reference_time / number_of_diagrams << " mcs per diagram, "
+		<< "in place " << 1e6 * in_place_time / number_of_diagrams << " mcs per diagram (" 
+		<< std::setprecision(0) << stat.number_of_states / std::max(in_place_time, 1e-9) << " states/s), "
+		<< std::setprecision(2) << "speedup " << reference_time / std::max(in_place_time, 1e-9) << ", "
+		<< "one traversal for both cases " << 1e6 * combined_time / number_of_diagrams << " mcs per diagram (" 
+		<< std::setprecision(0) << combined_stat.number_of_states / std::max(combined_time, 1e-9) << " states/s), "
+		<< std::setprecision(2) << "speedup " << in_place_time / std::max(combined_time, 1e-9)
+		<< (number_of_rows == number_of_reference_rows && number_of_combined_rows == number_of_rows ? "" : ", ERROR: the numbers of functions differ!") << std::endl;
+}
+
+// The same for the first diagrams of the given length.
+template<class chord_like_type>
+void benchmark_elimination(std::ostream& stream_out, int length, size_t max_number_of_diagrams) {
+	benchmark_elimination<chord_like_type>(stream_out, length, get_first_diagrams<chord_like_type>(length, max_number_of_diagrams));
+}
+
+// This function measures the cache of the function sets of residual diagrams (see function_set_cache) on the first diagrams of the given length.
+// The sets of both cases are constructed by all_linear_functions_for_both_cases without the cache, with an empty cache (as in the first run) 
+// and with the cache filled by the previous pass and read back from a file (as in a later run). 
+// It returns false if the sets with the cache differ from the ones without it, or if the cache is not read back from the file.
+template<class chord_like_type>
+bool benchmark_function_cache(std::ostream& stream_out, int length, size_t max_number_of_diagrams, int max_cached_residual_size) {
+	using function_type = typename chord_like_type::function_type;
+	auto diagrams = get_first_diagrams<chord_like_type>(length, max_number_of_diagrams);
+	std::vector<std::vector<function_type>> reference_sets, sets;
+	// The sets are sorted, since the order of the functions depends on the order of insertions.
+	auto traverse = [&](function_set_cache* cache, std::vector<std::vector<function_type>>& function_sets) {
+		function_sets.clear();
+		estimation_statistics stat;
+		auto start = std::chrono::steady_clock::now();
+		for (const auto& rhs_lhs : diagrams) {
+			typename chord_like_type::in_place_type diagram(rhs_lhs);
+			all_linear_functions_for_both_cases(diagram, length, stat, false, cache);
+			for (bool is_limit_case : { false, true }) {
+				const auto& results = get_thread_function_front<function_type>(is_limit_case);
+				function_sets.emplace_back(results.begin(), results.end());
+			}
+		}
+		double time = get_seconds_since(start);
+		for (auto& functions : function_sets)
+			std::sort(functions.begin(), functions.end());
+		return time;
+	};
+
+	double reference_time = traverse(nullptr, reference_sets);
+	function_set_cache cache(max_cached_residual_size);
+	double cold_time = traverse(&cache, sets);
+	bool is_correct = sets == reference_sets;
+	std::string file_name = "benchmark_" + get_class_name<chord_like_type>() + ".cache";
+	function_set_cache loaded_cache(max_cached_residual_size);
+	is_correct = cache.save(file_name) && loaded_cache.load(file_name) && loaded_cache.size() == cache.size() && is_correct;
+	std::remove(file_name.c_str());
+	double warm_time = traverse(&loaded_cache, sets);
+	is_correct = is_correct && sets == reference_sets;
+
+	size_t number_of_diagrams = std::max<size_t>(1, diagrams.size());
+	stream_out
+		<< "Function set cache, " << get_class_name<chord_like_type>() << " of length " << length << ", " << diagrams.size() << " diagrams, "
+		<< "residual diagrams with at most " << max_cached_residual_size << " weights: " << std::fixed << std::setprecision(2)
+		<< "without the cache " << 1e6 * reference_time / number_of_diagrams << " mcs per diagram, "
+		<< "empty cache " << 1e6 * cold_time / number_of_diagrams << " mcs per diagram (speedup " << reference_time / std::max(cold_time, 1e-9) << "), "
+		<< "cache from the file " << 1e6 * warm_time / number_of_diagrams << " mcs per diagram (speedup " << reference_time / std::max(warm_time, 1e-9) << "), "
+		<< cache.size() << " sets, " << 100. * cache.get_number_of_hits() / std::max(1ll, cache.get_number_of_lookups()) << "% of lookups found"
+		<< (is_correct ? "" : ", ERROR: the sets of functions differ!") << std::endl;
+	return is_correct;
+}
+
+// This function compares two ways of keeping the containers used for the LP of one diagram (the set of linear functions and the transposition table):
+// new containers for every diagram, and the containers of the thread, which are cleared, but not freed, between diagrams (see get_estimates_for_one_chord_diagram).
+// Both LPs of the first diagrams of the given length are solved, and the numbers of allocations and allocated bytes per diagram are printed
+// (the allocations inside the LP solver do not depend on the containers, so they are also printed separately).
+// Notice: the peak memory usage is the one of the whole process up to the end of each measurement.
+template<class chord_like_type>
+void benchmark_function_storage(std::ostream& stream_out, int length, size_t max_number_of_diagrams) {
+	using function_front = linear_function_front<typename chord_like_type::function_type>;
+	auto diagrams = get_first_diagrams<chord_like_type>(length, max_number_of_diagrams);
+	size_t number_of_diagrams = std::max<size_t>(1, diagrams.size());
+	double sum_of_values[2] = { 0., 0. };
+
+	for (bool is_reused : { false, true }) {
+		long long allocations = number_of_allocations, bytes = number_of_allocated_bytes, solver_allocations = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (const auto& rhs_lhs : diagrams) {
+			typename chord_like_type::in_place_type diagram(rhs_lhs);
+			for (bool is_limit_case : { false, true }) {
+				function_front new_results;
+				transposition_table new_visited_states;
+				std::vector<int> new_state_key;
+				thread_local std::vector<int> state_key;
+				function_front& results = is_reused ? get_thread_function_front<typename chord_like_type::function_type>() : new_results;
+				transposition_table& visited_states = is_reused ? get_thread_transposition_table() : new_visited_states;
+				results.clear();
+				visited_states.clear();
+				all_linear_functions_in_place(diagram, results, length, is_limit_case, visited_states, is_reused ? state_key : new_state_key);
+
+				long long allocations_before_solver = number_of_allocations;
+				sum_of_values[is_reused] += get_thread_lp_solver_context().solve(results, is_limit_case);
+				solver_allocations += number_of_allocations - allocations_before_solver;
+			}
+		}
+		double time = get_seconds_since(start);
+		stream_out
+			<< "Storage of functions, " << get_class_name<chord_like_type>() << " of length " << length << ", " << diagrams.size() << " diagrams, "
+			<< (is_reused ? "reused containers: " : "new containers: ") << std::fixed << std::setprecision(2)
+			<< static_cast<double>(number_of_allocations - allocations) / number_of_diagrams << " allocations ("
+			<< static_cast<double>(solver_allocations) / number_of_diagrams << " of them in the LP solver) and "
+			<< static_cast<double>(number_of_allocated_bytes - bytes) / number_of_diagrams / 1024. << " KB per diagram, "
+			<< 1e6 * time / number_of_diagrams << " mcs per diagram, peak memory usage " << get_peak_memory_usage() << " MB" << std::endl;
+	}
+	if (std::abs(sum_of_values[0] - sum_of_values[1]) > 1e-9 * std::max(1., std::abs(sum_of_values[0])))
+		stream_out << "ERROR: the values differ!" << std::endl;
+}
+
+// This function compares three ways of solving the LPs of the given diagrams: create_solver, which creates all ALGLIB objects 
+// for every problem, lp_solver_context, which keeps them between consecutive problems, and max_min_solver. Both LPs (m = 8 and the limit case) are solved.
+// The problems are recorded before the measurements, and the values of both solvers are compared with the ones of create_solver.
+// It returns false if the values of max_min_solver differ from them by more than 1e-7 relative to the value, which is much more than the rounding errors.
+template<class chord_like_type>
+bool benchmark_lp_solver(std::ostream& stream_out, int length, const std::vector<std::vector<int>>& diagrams) {
+	bool is_correct = true;
+	for (bool is_limit_case : { false, true }) {
+		auto function_sets = record_function_sets<chord_like_type>(diagrams, length, is_limit_case);
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<double> cold_values;
+		for (const auto& functions : function_sets)
+			cold_values.push_back(create_solver(functions, is_limit_case));
+		double cold_time = get_seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		lp_solver_context context;
+		double max_difference = 0.;
+		for (size_t i = 0; i < function_sets.size(); ++i)
+			max_difference = std::max(max_difference, std::abs(context.solve(function_sets[i], is_limit_case) - cold_values[i]));
+		double warm_time = get_seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		max_min_solver solver;
+		std::vector<double> max_min_values;
+		for (const auto& functions : function_sets)
+			max_min_values.push_back(solver.solve(functions, is_limit_case));
+		double max_min_time = get_seconds_since(start);
+		double max_min_difference = 0.;
+		for (size_t i = 0; i < function_sets.size(); ++i) {
+			max_min_difference = std::max(max_min_difference, std::abs(max_min_values[i] - cold_values[i]));
+			is_correct = is_correct && std::abs(max_min_values[i] - cold_values[i]) <= 1e-7 * std::max(1., std::abs(cold_values[i]));
+		}
+
+		size_t number_of_lp = std::max<size_t>(1, function_sets.size());
+		stream_out
+			<< "LP solver, " << get_class_name<chord_like_type>() << " of length " << length << (is_limit_case ? ", limit case" : ", m = 8")
+			<< ", " << function_sets.size() << " problems: "
+			<< std::fixed << std::setprecision(2)
+			<< "cold " << 1e6 * cold_time / number_of_lp << " mcs per LP (" 
+			<< std::setprecision(0) << function_sets.size() / std::max(cold_time, 1e-9) << " LPs/s), "
+			<< std::setprecision(2) << "warm " << 1e6 * warm_time / number_of_lp << " mcs per LP ("
+			<< static_cast<double>(context.get_number_of_iterations()) / number_of_lp << " iterations per LP), "
+			<< "speedup " << cold_time / std::max(warm_time, 1e-9)
+			<< std::scientific << std::setprecision(2) << ", max difference " << max_difference << std::endl
+			<< std::fixed << "    max-min solver " << 1e6 * max_min_time / number_of_lp << " mcs per LP ("
+			<< std::setprecision(0) << function_sets.size() / std::max(max_min_time, 1e-9) << " LPs/s, "
+			<< std::setprecision(2) << static_cast<double>(solver.get_number_of_iterations()) / number_of_lp << " iterations per LP), "
+			<< "speedup over warm " << warm_time / std::max(max_min_time, 1e-9)
+			<< std::scientific << std::setprecision(2) << ", max difference " << max_min_difference 
+			<< (is_correct ? "" : ", ERROR: the values differ!") << std::endl;
+	}
+	return is_correct;
+}
+
+// The same for the first diagrams of the given length.
+template<class chord_like_type>
+bool benchmark_lp_solver(std::ostream& stream_out, int length, size_t max_number_of_diagrams) {
+	return benchmark_lp_solver<chord_like_type>(stream_out, length, get_first_diagrams<chord_like_type>(length, max_number_of_diagrams));
+}
+
+// This function compares the solution of the LPs of the given diagrams for all functions with the row generation (see solve_by_row_generation),
+// both by max_min_solver and by lp_solver_context. It prints the average number of rows of the whole LP and of the last LP of the row generation,
+// the average number of rounds and the times. The problems are recorded before the measurements.
+// It returns false if the values of the row generation differ from the ones for all functions by more than 1e-7 relative to the value.
+template<class chord_like_type>
+bool benchmark_row_generation(std::ostream& stream_out, int length, const std::vector<std::vector<int>>& diagrams) {
+	bool is_correct = true;
+	for (bool is_limit_case : { false, true }) {
+		auto function_sets = record_function_sets<chord_like_type>(diagrams, length, is_limit_case);
+		size_t number_of_rows = 0;
+		for (const auto& functions : function_sets)
+			number_of_rows += functions.size();
+		size_t number_of_lp = std::max<size_t>(1, function_sets.size());
+
+		auto measure = [&](auto& solver, bool use_row_generation, estimation_statistics& stat, std::vector<double>& values) {
+			auto start = std::chrono::steady_clock::now();
+			for (const auto& functions : function_sets)
+				values.push_back(use_row_generation ? solve_by_row_generation(solver, functions, is_limit_case, stat) : solver.solve(functions, is_limit_case));
+			return get_seconds_since(start);
+		};
+		stream_out << "Row generation, " << get_class_name<chord_like_type>() << " of length " << length << (is_limit_case ? ", limit case" : ", m = 8")
+			<< ", " << function_sets.size() << " problems with " << std::fixed << std::setprecision(2) << static_cast<double>(number_of_rows) / number_of_lp 
+			<< " rows on average:" << std::endl;
+		for (bool use_alglib_lp_solver : { false, true }) {
+			max_min_solver max_min;
+			lp_solver_context context;
+			estimation_statistics stat;
+			std::vector<double> values, generated_values;
+			double time = use_alglib_lp_solver ? measure(context, false, stat, values) : measure(max_min, false, stat, values);
+			double generated_time = use_alglib_lp_solver ? measure(context, true, stat, generated_values) : measure(max_min, true, stat, generated_values);
+			double max_difference = 0.;
+			for (size_t i = 0; i < values.size(); ++i) {
+				max_difference = std::max(max_difference, std::abs(generated_values[i] - values[i]));
+				is_correct = is_correct && std::abs(generated_values[i] - values[i]) <= 1e-7 * std::max(1., std::abs(values[i]));
+			}
+			stream_out
+				<< "    " << (use_alglib_lp_solver ? "ALGLIB" : "max-min solver") << ": " << std::fixed << std::setprecision(2)
+				<< "all rows " << 1e6 * time / number_of_lp << " mcs per LP, "
+				<< "row generation " << 1e6 * generated_time / number_of_lp << " mcs per LP ("
+				<< static_cast<double>(stat.number_of_generated_rows) / number_of_lp << " rows, " 
+				<< static_cast<double>(stat.number_of_row_generation_rounds) / number_of_lp << " rounds per LP), "
+				<< "speedup " << time / std::max(generated_time, 1e-9)
+				<< std::scientific << std::setprecision(2) << ", max difference " << max_difference
+				<< (is_correct ? "" : ", ERROR: the values differ!") << std::endl;
+		}
+	}
+	return is_correct;
+}
+
+// The same for the first diagrams of the given length.
+template<class chord_like_type>
+bool benchmark_row_generation(std::ostream& stream_out, int length, size_t max_number_of_diagrams) {
+	return benchmark_row_generation<chord_like_type>(stream_out, length, get_first_diagrams<chord_like_type>(length, max_number_of_diagrams));
+}
+
+// This function proves the estimates of the first diagrams of the given length exactly (see certify_estimate) and compares them
+// with the floating-point ones. It prints the times per LP of the floating-point solver and of the certification, the number of proofs 
+// that failed and the maximum difference between the values. The problems are recorded before the measurements.
+// It returns false if some exact value differs from the floating-point one by more than 1e-7 relative to the value.
+template<class chord_like_type>
+bool benchmark_certification(std::ostream& stream_out, int length, size_t max_number_of_diagrams) {
+	auto diagrams = get_first_diagrams<chord_like_type>(length, max_number_of_diagrams);
+	bool is_correct = true;
+	for (bool is_limit_case : { false, true }) {
+		auto function_sets = record_function_sets<chord_like_type>(diagrams, length, is_limit_case);
+		size_t number_of_lp = std::max<size_t>(1, function_sets.size());
+		max_min_solver solver;
+		std::vector<double> values;
+		auto start = std::chrono::steady_clock::now();
+		for (const auto& functions : function_sets)
+			values.push_back(solver.solve(functions, is_limit_case));
+		double time = get_seconds_since(start);
+
+		estimation_statistics stat;
+		std::vector<long long> numerators(function_sets.size(), 0), denominators(function_sets.size(), 0);
+		start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < function_sets.size(); ++i)
+			certify_estimate(function_sets[i], is_limit_case, stat, numerators[i], denominators[i]);
+		double certification_time = get_seconds_since(start);
+
+		double max_difference = 0.;
+		long long max_denominator = 0;
+		for (size_t i = 0; i < values.size(); ++i) {
+			if (denominators[i] == 0)
+				continue;
+			double difference = std::abs(static_cast<double>(numerators[i]) / denominators[i] - values[i]);
+			max_difference = std::max(max_difference, difference);
+			max_denominator = std::max(max_denominator, denominators[i]);
+			is_correct = is_correct && difference <= 1e-7 * std::max(1., std::abs(values[i]));
+		}
+		stream_out
+			<< "Certification, " << get_class_name<chord_like_type>() << " of length " << length << (is_limit_case ? ", limit case" : ", m = 8")
+			<< ", " << function_sets.size() << " problems: " << std::fixed << std::setprecision(2)
+			<< "floating point " << 1e6 * time / number_of_lp << " mcs per LP, exact proof " << 1e6 * certification_time / number_of_lp << " mcs per LP, "
+			<< stat.number_of_failed_certificates << " not proved, the largest denominator " << max_denominator
+			<< std::scientific << std::setprecision(2) << ", max difference " << max_difference
+			<< (is_correct ? "" : ", ERROR: the values differ!") << std::endl;
+	}
+	return is_correct;
+}
+
+// This function compares the sweep over the sizes of the starting curve (see solve_for_curve_sizes), where every LP starts from the basis 
+// of the previous one, with solving every LP from scratch, on the first diagrams of the given length. 
+// It returns false if the values differ by more than 1e-7 relative to the value, or if the value for m = 8 differs from the usual LP.
+template<class chord_like_type>
+bool benchmark_curve_sizes(std::ostream& stream_out, int length, size_t max_number_of_diagrams, const std::vector<double>& curve_sizes) {
+	auto function_sets = record_function_sets<chord_like_type>(get_first_diagrams<chord_like_type>(length, max_number_of_diagrams), length, false);
+	bool is_correct = true;
+	double max_difference = 0.;
+	auto check = [&](double value, double reference_value) {
+		max_difference = std::max(max_difference, std::abs(value - reference_value));
+		is_correct = is_correct && std::abs(value - reference_value) <= 1e-7 * std::max(1., std::abs(reference_value));
+	};
+
+	estimation_statistics stat;
+	std::vector<std::vector<double>> values(function_sets.size());
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < function_sets.size(); ++i)
+		solve_for_curve_sizes(function_sets[i], curve_sizes, values[i], stat);
+	double sweep_time = get_seconds_since(start);
+
+	max_min_solver solver;
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < function_sets.size(); ++i)
+		for (size_t j = 0; j < curve_sizes.size(); ++j)
+			check(values[i][j], solver.solve_for_curve_size(function_sets[i], curve_sizes[j]));
+	double cold_time = get_seconds_since(start);
+	for (size_t i = 0; i < function_sets.size(); ++i)
+		for (size_t j = 0; j < curve_sizes.size(); ++j)
+			if (curve_sizes[j] == 8.)
+				check(values[i][j], solver.solve(function_sets[i], false));
+
+	size_t number_of_lp = std::max<size_t>(1, function_sets.size() * curve_sizes.size());
+	stream_out
+		<< "Sizes of the starting curve, " << get_class_name<chord_like_type>() << " of length " << length << ", " << function_sets.size() << " diagrams, "
+		<< curve_sizes.size() << " sizes: " << std::fixed << std::setprecision(2)
+		<< "from the previous basis " << 1e6 * sweep_time / number_of_lp << " mcs per LP (" 
+		<< static_cast<double>(stat.number_of_curve_size_iterations) / number_of_lp << " iterations per LP), "
+		<< "from scratch " << 1e6 * cold_time / number_of_lp << " mcs per LP, speedup " << cold_time / std::max(sweep_time, 1e-9)
+		<< std::scientific << std::setprecision(2) << ", max difference " << max_difference
+		<< (is_correct ? "" : ", ERROR: the values differ!") << std::endl;
+	return is_correct;
+}
+
+// This function returns a fixed set of hard diagrams: the number_of_diagrams diagrams with the largest LPs (for m = 8) among the first 
+// max_number_of_candidates diagrams of the given length, in the order of walk_trough_all_diagrams. 
+// The size of an LP (the number of non-dominated linear functions) does not depend on the implementation, so the set is the same for different versions.
+template<class chord_like_type>
+std::vector<std::vector<int>> get_hard_diagrams(int length, size_t max_number_of_candidates, size_t number_of_diagrams) {
+	auto candidates = get_first_diagrams<chord_like_type>(length, max_number_of_candidates);
+	auto function_sets = record_function_sets<chord_like_type>(candidates, length, false);
+	std::vector<size_t> indices(candidates.size());
+	for (size_t i = 0; i < indices.size(); ++i)
+		indices[i] = i;
+	std::stable_sort(indices.begin(), indices.end(), [&function_sets](size_t i, size_t j) { return function_sets[i].size() > function_sets[j].size(); });
+	indices.resize(std::min(number_of_diagrams, indices.size()));
+	std::sort(indices.begin(), indices.end());
+
+	std::vector<std::vector<int>> diagrams;
+	for (size_t i : indices)
+		diagrams.push_back(candidates[i]);
+	return diagrams;
+}
+
+// This function measures the elimination and the LP stages (see benchmark_elimination, benchmark_lp_solver and benchmark_row_generation) 
+// on the hard diagrams, see get_hard_diagrams.
+// It returns false if the values of the LP solvers differ.
+template<class chord_like_type>
+bool benchmark_hard_diagrams(std::ostream& stream_out, int length, size_t max_number_of_candidates, size_t number_of_diagrams) {
+	auto diagrams = get_hard_diagrams<chord_like_type>(length, max_number_of_candidates, number_of_diagrams);
+	stream_out << "Hard diagrams: " << diagrams.size() << " " << get_class_name<chord_like_type>() << " of length " << length 
+		<< " with the largest LPs among the first " << max_number_of_candidates << std::endl;
+	benchmark_elimination<chord_like_type>(stream_out, length, diagrams);
+	bool is_correct = benchmark_lp_solver<chord_like_type>(stream_out, length, diagrams);
+	return benchmark_row_generation<chord_like_type>(stream_out, length, diagrams) && is_correct;
+}
+
+// This function measures the sharing of the eliminations of one diagram with the idle threads (see elimination_job) on the number_of_diagrams diagrams
+// with the largest trees of eliminations (the most elimination states) among the first max_number_of_candidates diagrams of the given length.
+// They are given to a pool of number_of_threads threads, one task per diagram, so the threads without a diagram are idle 
+// and the time is the time of the largest diagram, as at the end of a calculation. The pool runs without the sharing and with the sharing 
+// of the states with at least min_moves_to_share remaining eliminations. The time of a single thread is given for comparison.
+// Notice: the speedup is only possible if the machine has enough cores.
+// It returns false if the sets of functions (of both cases) with the sharing differ from the ones of a single thread.
+template<class chord_like_type>
+bool benchmark_shared_elimination(std::ostream& stream_out, int length, size_t max_number_of_candidates, size_t number_of_diagrams, 
+	int number_of_threads, int min_moves_to_share) {
+	using function_type = typename chord_like_type::function_type;
+	using in_place_type = typename chord_like_type::in_place_type;
+	auto candidates = get_first_diagrams<chord_like_type>(length, max_number_of_candidates);
+	std::vector<std::pair<long long, size_t>> sizes;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		estimation_statistics candidate_stat;
+		in_place_type diagram(candidates[i]);
+		all_linear_functions_for_both_cases(diagram, length, candidate_stat);
+		sizes.emplace_back(-candidate_stat.number_of_states, i);
+	}
+	std::sort(sizes.begin(), sizes.end());
+	std::vector<std::vector<int>> diagrams;
+	for (size_t i = 0; i < std::min(number_of_diagrams, sizes.size()); ++i)
+		diagrams.push_back(candidates[sizes[i].second]);
+	// The sets are sorted, since the order of the functions depends on the order of insertions.
+	auto get_sets = [](std::vector<function_type>& set_8, std::vector<function_type>& set_limit) {
+		for (bool is_limit_case : { false, true }) {
+			const auto& results = get_thread_function_front<function_type>(is_limit_case);
+			auto& functions = is_limit_case ? set_limit : set_8;
+			functions.assign(results.begin(), results.end());
+			std::sort(functions.begin(), functions.end());
+		}
+	};
+
+	std::vector<std::vector<function_type>> reference_sets(2 * diagrams.size()), sets(2 * diagrams.size());
+	estimation_statistics stat;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < diagrams.size(); ++i) {
+		in_place_type diagram(diagrams[i]);
+		all_linear_functions_for_both_cases(diagram, length, stat);
+		get_sets(reference_sets[2 * i], reference_sets[2 * i + 1]);
+	}
+	double serial_time = get_seconds_since(start);
+
+	auto run_pool = [&](int min_moves) {
+		work_stealing_pool<walk_task> pool(number_of_threads);
+		std::vector<estimation_statistics> pool_stat(number_of_threads);
+		for (size_t i = 0; i < diagrams.size(); ++i) {
+			walk_task task;
+			task.unit = static_cast<int>(i);
+			pool.push(task.unit, std::move(task));
+		}
+		auto pool_start = std::chrono::steady_clock::now();
+		pool.run([&](int worker, walk_task& task) {
+			if (task.shared_states) {
+				task.shared_states(pool_stat[worker]);
+				return;
+			}
+			std::shared_ptr<elimination_job<in_place_type>> job;
+			if (min_moves > 0)
+				job = make_elimination_job<in_place_type>(pool, worker, length, min_moves);
+			in_place_type diagram(diagrams[task.unit]);
+			all_linear_functions_for_both_cases(diagram, length, pool_stat[worker], false, nullptr, job.get());
+			get_sets(sets[2 * task.unit], sets[2 * task.unit + 1]);
+		});
+		double time = get_seconds_since(pool_start);
+		for (const auto& worker_stat : pool_stat)
+			stat += worker_stat;
+		return time;
+	};
+	double pool_time = run_pool(0);
+	bool is_correct = sets == reference_sets;
+	stat = estimation_statistics();
+	double shared_time = run_pool(min_moves_to_share);
+	is_correct = is_correct && sets == reference_sets;
+
+	stream_out
+		<< "Shared elimination, " << diagrams.size() << " largest " << get_class_name<chord_like_type>() << " of length " << length << ", " 
+		<< number_of_threads << " threads (" << std::thread::hardware_concurrency() << " cores), states with at least " << min_moves_to_share 
+		<< " remaining eliminations: " << std::fixed << std::setprecision(3) << "one thread " << serial_time << " sec, "
+		<< "a thread per diagram " << pool_time << " sec, with the sharing " << shared_time << " sec (speedup " << pool_time / std::max(shared_time, 1e-9) 
+		<< "), " << stat.number_of_shared_states << " states shared, " << stat.number_of_helped_states << " expanded by other threads"
+		<< (is_correct ? "" : ", ERROR: the sets of functions differ!") << std::endl;
+	return is_correct;
+}
+
+//Technical class. The results for one length written by get_main_estimates, i.e. the reference values stored in "Files with numbers".
+class reference_values {
+public:
+	long long number_of_diag = -1;		// It is -1 if there is no result for this length.
+	double value_8 = -1.;				// The values as they are written, i.e. max_value_8 / 8 + 1 and max_value_limit + 1.
+	double value_limit = -1.;
+};
+
+// Technical function. It reads the results written by get_main_estimates (see make_simple_output). The results are indexed by the length.
+std::vector<reference_values> read_reference_values(const std::string& file_name) {
+	std::vector<reference_values> values(n_max + 1);
+	std::ifstream file_in(file_name);
+	std::string line;
+	while (std::getline(file_in, line)) {
+		size_t length_position = line.find("of length"), number_position = line.find("considered is"), values_position = line.find("Worst values are");
+		if (length_position == std::string::npos || number_position == std::string::npos || values_position == std::string::npos)
+			continue;
+		int length = std::atoi(line.c_str() + length_position + 9);
+		if (length < 1 || length > n_max)
+			continue;
+		reference_values& value = values[length];
+		value.number_of_diag = std::atoll(line.c_str() + number_position + 13);
+		std::istringstream stream_in(line.substr(values_position + 16));
+		std::string and_word;
+		stream_in >> value.value_8 >> and_word >> value.value_limit;
+	}
+	return values;
+}
+
+// Technical function. It returns true if the value coincides with the reference one up to the 6 significant digits written in the files.
+bool is_equal_to_reference(double value, double reference_value) noexcept {
+	return std::abs(value - reference_value) <= 1e-5 * std::max(1., std::abs(reference_value));
+}
+
+// This function runs the full calculation (find_worst_diagrams with the given options) for all lengths from 1 to max_length 
+// and prints the throughput of the stages: diagrams, elimination states and LPs per second. The enumeration of the interesting diagrams alone 
+// (i.e. get_first_diagrams) is timed separately and compared with the enumeration that rescans the prefixes (see collect_diagrams_by_rescanning), 
+// and the sequences of diagrams must coincide. The number of diagrams and the worst values are compared with the reference file 
+// (see get_main_estimates), and the function returns false if any of them differs, so an optimization that changes a number is noticed immediately.
+// If pinned_values_8 is not empty, its element with the index length - 1 replaces the reference value for m = 8 of that length 
+// (e.g. the values stored for ACD were computed by an earlier version, see README.md).
+template<template<int> class diagram_family>
+bool benchmark_enumeration(std::ostream& stream_out, int max_length, const std::string& reference_file, 
+	const std::vector<double>& pinned_values_8 = std::vector<double>(), const estimation_options& options = estimation_options()) {
+	auto reference = read_reference_values(reference_file);
+	for (size_t i = 0; i < pinned_values_8.size() && i + 1 < reference.size(); ++i)
+		reference[i + 1].value_8 = pinned_values_8[i];
+	bool is_correct = true;
+	for (int length = 1; length <= max_length; ++length) {
+		double enumeration_time = 0., rescanning_time = 0.;
+		bool is_same_sequence = true;
+		auto enumerate = [length, &enumeration_time, &rescanning_time, &is_same_sequence](auto tag) {
+			using chord_like_type = typename decltype(tag)::type;
+			auto start = std::chrono::steady_clock::now();
+			auto diagrams = get_first_diagrams<chord_like_type>(length, SIZE_MAX);
+			enumeration_time = get_seconds_since(start);
+			start = std::chrono::steady_clock::now();
+			std::vector<std::vector<int>> reference_diagrams;
+			std::vector<int> rhs_lhs;
+			collect_diagrams_by_rescanning<chord_like_type>(rhs_lhs, reference_diagrams, length, 1);
+			rescanning_time = get_seconds_since(start);
+			is_same_sequence = diagrams == reference_diagrams;
+			return diagrams.size(); 
+		};
+		size_t number_of_enumerated = length_dispatcher<diagram_family>::call(length, enumerate);
+		is_correct = is_correct && is_same_sequence;
+
+		auto start = std::chrono::steady_clock::now();
+		estimation_statistics stat;
+		estimation_result result = find_worst_diagrams<diagram_family>(length, options, &stat);
+		double time = std::max(get_seconds_since(start), 1e-9);
+
+		stream_out
+			<< "Enumeration, " << get_class_name<diagram_family>() << " of length " << length << ", " << result.number_of_diag << " diagrams: "
+			<< std::fixed << std::setprecision(0)
+			<< "enumeration only " << number_of_enumerated / std::max(enumeration_time, 1e-9) << " diagrams/s (rescanning " 
+			<< number_of_enumerated / std::max(rescanning_time, 1e-9) << " diagrams/s" << (is_same_sequence ? "" : ", ERROR: the sequences differ!") << "), full calculation "
+			<< std::setprecision(2) << time << " sec. (" << std::setprecision(0)
+			<< result.number_of_diag / time << " diagrams/s, " << stat.number_of_states / time << " states/s, " << stat.number_of_lp / time << " LPs/s)";
+
+		double value_8 = result.value_8 / 8. + 1., value_limit = result.value_limit + 1.;
+		const reference_values& expected = reference[length];
+		if (expected.number_of_diag < 0)
+			stream_out << ", no reference values" << std::endl;
+		else if (expected.number_of_diag == result.number_of_diag && static_cast<long long>(number_of_enumerated) == result.number_of_diag
+			&& is_equal_to_reference(value_8, expected.value_8) && is_equal_to_reference(value_limit, expected.value_limit))
+			stream_out << ", the reference values coincide" << std::endl;
+		else {
+			is_correct = false;
+			stream_out << std::setprecision(6) << std::defaultfloat
+				<< ", ERROR: the results " << number_of_enumerated << " (enumerated), " << result.number_of_diag << ", " << value_8 << " and " << value_limit
+				<< " differ from the reference " << expected.number_of_diag << ", " << expected.value_8 << " and " << expected.value_limit << "!" << std::endl;
+		}
+	}
+	return is_correct;
+}
+
+// This function runs the checks of brute_force_functions.h for all lengths from 1 to max_length: the symmetry reduction (see verify_symmetry_reduction)
+// and the classes with transformations applied in place for the first max_number_of_diagrams diagrams (see verify_in_place_elimination).
+// It returns false if some check fails.
+template<template<int> class diagram_family>
+bool benchmark_verification(std::ostream& stream_out, int max_length, size_t max_number_of_diagrams) {
+	bool is_correct = true;
+	for (int length = 1; length <= max_length; ++length) {
+		auto start = std::chrono::steady_clock::now();
+		bool is_symmetry_correct = verify_symmetry_reduction<diagram_family>(length);
+		bool is_in_place_correct = verify_in_place_elimination<diagram_family>(length, max_number_of_diagrams);
+		is_correct = is_correct && is_symmetry_correct && is_in_place_correct;
+		stream_out << "Verification, " << get_class_name<diagram_family>() << " of length " << length << ": "
+			<< "symmetry reduction " << (is_symmetry_correct ? "correct" : "ERROR: the results differ!") << ", "
+			<< "elimination in place " << (is_in_place_correct ? "correct" : "ERROR: the functions differ!") 
+			<< std::fixed << std::setprecision(2) << " (" << get_seconds_since(start) << " sec.)" << std::endl;
+	}
+	return is_correct;
+}
+
+// This function exports all (pre)ACD of the given length to a corpus (see export_diagram_corpus) and compares the corpus with the enumeration:
+// the time of reading and unpacking all diagrams from the file with the enumeration alone (get_first_diagrams), and the full calculation
+// (find_worst_diagrams with the given options) with the diagrams read from the corpus with the one with the enumeration.
+// The sequences of diagrams, the numbers of diagrams and the worst values must coincide, otherwise the function returns false.
+// The corpus is written to the current directory and removed at the end.
+template<template<int> class diagram_family>
+bool benchmark_diagram_corpus(std::ostream& stream_out, int length, estimation_options options = estimation_options()) {
+	std::string prefix = "benchmark";
+	std::string file_name = prefix + "_" + get_class_name<diagram_family>() + "_" + std::to_string(length) + ".corpus";
+	double export_time = 0., enumeration_time = 0., reading_time = 0.;
+	long long number_of_diagrams = 0;
+	bool is_same_sequence = true;
+	auto compare = [&](auto tag) {
+		using chord_like_type = typename decltype(tag)::type;
+		auto start = std::chrono::steady_clock::now();
+		number_of_diagrams = export_diagram_corpus<chord_like_type>(length, file_name);
+		export_time = get_seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		auto diagrams = get_first_diagrams<chord_like_type>(length, SIZE_MAX);
+		enumeration_time = get_seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		diagram_corpus corpus;
+		is_same_sequence = corpus.open(file_name, chord_like_type::is_pre_ACD ? 1 : 0, length) 
+			&& corpus.get_number_of_diagrams() == static_cast<long long>(diagrams.size());
+		std::vector<int> rhs_lhs;
+		long long checksum = 0;
+		for (long long i = 0; i < corpus.get_number_of_diagrams(); ++i) {
+			corpus.get_diagram(i, rhs_lhs);
+			checksum += rhs_lhs.back();
+		}
+		reading_time = get_seconds_since(start);
+		for (long long i = 0; is_same_sequence && i < corpus.get_number_of_diagrams(); ++i) {
+			corpus.get_diagram(i, rhs_lhs);
+			is_same_sequence = rhs_lhs == diagrams[i];
+		}
+		return checksum;
+	};
+	length_dispatcher<diagram_family>::call(length, compare);
+
+	options.corpus_prefix.clear();
+	auto start = std::chrono::steady_clock::now();
+	estimation_result reference = find_worst_diagrams<diagram_family>(length, options);
+	double reference_time = std::max(get_seconds_since(start), 1e-9);
+	options.corpus_prefix = prefix;
+	start = std::chrono::steady_clock::now();
+	estimation_result result = find_worst_diagrams<diagram_family>(length, options);
+	double time = std::max(get_seconds_since(start), 1e-9);
+
+	std::ifstream file_in(file_name, std::ios::binary | std::ios::ate);
+	double file_size = file_in ? static_cast<double>(file_in.tellg()) : 0.;
+	file_in.close();
+	std::remove(file_name.c_str());
+
+	bool is_correct = is_same_sequence && number_of_diagrams == reference.number_of_diag && result.number_of_diag == reference.number_of_diag
+		&& result.value_8 == reference.value_8 && result.value_limit == reference.value_limit;
+	stream_out
+		<< "Diagram corpus, " << get_class_name<diagram_family>() << " of length " << length << ", " << number_of_diagrams << " diagrams, "
+		<< std::fixed << std::setprecision(2) << file_size / std::max(1ll, number_of_diagrams) << " bytes per diagram: "
+		<< "export " << export_time << " sec., " << std::setprecision(0)
+		<< "enumeration only " << number_of_diagrams / std::max(enumeration_time, 1e-9) << " diagrams/s, "
+		<< "reading the corpus " << number_of_diagrams / std::max(reading_time, 1e-9) << " diagrams/s, " << std::setprecision(2)
+		<< "full calculation " << reference_time << " sec. with the enumeration and " << time << " sec. with the corpus"
+		<< (is_correct ? "" : ", ERROR: the results differ!") << std::endl;
+	return is_correct;
+}
+
+// This function checks the planner (see plan_workload): the predicted numbers of diagrams of all lengths from 1 to max_planned_length 
+// are compared with the reference file, and they must coincide up to 5 standard errors. Then the units of length check_length are divided into
+// number_of_parts parts of equal predicted cost, every part is calculated as a shard in one thread, and the predicted and the measured times
+// of the parts are printed. The merged number of diagrams must coincide with the reference, otherwise the function returns false.
+template<template<int> class diagram_family>
+bool benchmark_planner(std::ostream& stream_out, int max_planned_length, int check_length, int number_of_parts, const std::string& reference_file) {
+	auto reference = read_reference_values(reference_file);
+	bool is_correct = true;
+	for (int length = 1; length <= max_planned_length; ++length) {
+		workload_plan plan = plan_workload<diagram_family>(length, 1);
+		long long expected = reference[length].number_of_diag;
+		double deviation = expected < 0 ? 0. : (plan.number_of_diagrams - expected) / std::max(plan.number_of_diagrams_error, 1e-9);
+		bool is_close = expected < 0 || std::abs(plan.number_of_diagrams - expected) <= 5. * plan.number_of_diagrams_error + 0.5;
+		is_correct = is_correct && is_close;
+		stream_out
+			<< "Planner, " << get_class_name<diagram_family>() << " of length " << length << ": " << std::fixed << std::setprecision(0)
+			<< plan.number_of_diagrams << " +- " << plan.number_of_diagrams_error << " diagrams predicted in " << std::setprecision(2) << plan.sampling_time 
+			<< " sec., " << plan.cpu_time << " CPU sec., " << plan.memory_per_thread / 1048576. << " MB per thread";
+		if (expected < 0)
+			stream_out << ", no reference values" << std::endl;
+		else
+			stream_out << ", the reference is " << expected << " (" << std::showpos << deviation << std::noshowpos << " standard errors)"
+				<< (is_close ? "" : ", ERROR: the prediction is too far!") << std::endl;
+	}
+
+	workload_plan plan = plan_workload<diagram_family>(check_length, number_of_parts);
+	estimation_options options;
+	options.number_of_threads = 1;
+	options.number_of_shards = number_of_parts;
+	options.shard_boundaries = plan.part_boundaries;
+	estimation_result result;
+	double max_time = 0., total_time = 0.;
+	stream_out << "Planner, " << get_class_name<diagram_family>() << " of length " << check_length << ", " << number_of_parts << " parts in one thread:";
+	for (int p = 0; p < number_of_parts; ++p) {
+		options.shard_index = p;
+		auto start = std::chrono::steady_clock::now();
+		result += find_worst_diagrams<diagram_family>(check_length, options);
+		double time = get_seconds_since(start);
+		max_time = std::max(max_time, time);
+		total_time += time;
+		stream_out << std::fixed << std::setprecision(2) << " " << plan.part_costs[p] << " (" << time << ")";
+	}
+	long long expected = reference[check_length].number_of_diag;
+	bool is_same = expected < 0 || result.number_of_diag == expected;
+	is_correct = is_correct && is_same;
+	stream_out << " sec. predicted (measured), total " << plan.cpu_time << " (" << total_time << ") sec., the longest part is " 
+		<< max_time * number_of_parts / std::max(total_time, 1e-9) << " of the average" << (is_same ? "" : ", ERROR: the number of diagrams differs!") << std::endl;
+	return is_correct;
+}
+
+// This function divides the units of the given length into number_of_shards shards, which are dealt in turn (see is_unit_in_shard), 
+// runs every shard with run_shard and merges the files with merge_shard_files. The merged results must coincide with the ones of a single run. 
+// Then the partition or the settings stored in one file are changed, and the merge must reject the files. Otherwise the function returns false.
+// The files are written to the current directory and removed at the end.
+template<template<int> class diagram_family>
+bool benchmark_shards(std::ostream& stream_out, int length, int number_of_shards) {
+	auto start = std::chrono::steady_clock::now();
+	estimation_result reference = find_worst_diagrams<diagram_family>(length, estimation_options());
+	double reference_time = get_seconds_since(start);
+
+	estimation_options options;
+	options.number_of_shards = number_of_shards;
+	std::vector<std::string> file_names;
+	bool is_written = true;
+	double max_time = 0., total_time = 0.;
+	for (int i = 0; i < number_of_shards; ++i) {
+		options.shard_index = i;
+		file_names.push_back("benchmark_" + get_class_name<diagram_family>() + "_" + std::to_string(length) + "_shard" + std::to_string(i) + ".txt");
+		start = std::chrono::steady_clock::now();
+		is_written = run_shard<diagram_family>(length, options, file_names.back()) && is_written;
+		double time = get_seconds_since(start);
+		max_time = std::max(max_time, time);
+		total_time += time;
+	}
+	std::ostringstream merged_output;
+	estimation_result result;
+	bool is_merged = is_written && merge_shard_files<diagram_family>(file_names, merged_output, &result);
+	bool is_same = is_merged && result.number_of_diag == reference.number_of_diag 
+		&& result.value_8 == reference.value_8 && result.value_limit == reference.value_limit;
+
+	// Another partition of the units into shards and other settings in the last file.
+	shard_result shard;
+	{
+		std::ifstream file_in(file_names.back());
+		file_in >> shard;
+	}
+	auto is_rejected_with = [&](const shard_result& changed_shard) {
+		{
+			std::ofstream file_out(file_names.back());
+			file_out << changed_shard;
+		}
+		return !merge_shard_files<diagram_family>(file_names, merged_output);
+	};
+	shard_result changed_shard = shard;
+	changed_shard.shard_boundaries.assign(number_of_shards + 1, 0);
+	changed_shard.shard_boundaries.back() = 1;
+	bool is_rejected = is_rejected_with(changed_shard);
+	options.use_symmetry_reduction = !options.use_symmetry_reduction;
+	options.shard_index = 0;
+	changed_shard = shard;
+	changed_shard.fingerprint = options.get_fingerprint();
+	is_rejected = is_rejected_with(changed_shard) && is_rejected;
+	for (const auto& file_name : file_names)
+		std::remove(file_name.c_str());
+
+	stream_out
+		<< "Shards, " << get_class_name<diagram_family>() << " of length " << length << ", " << number_of_shards << " shards: " 
+		<< std::fixed << std::setprecision(2) << "single run " << reference_time << " sec., all shards " << total_time << " sec., the longest shard " 
+		<< max_time << " sec." << (is_merged ? "" : ", ERROR: the files cannot be merged!") 
+		<< (is_same || !is_merged ? "" : ", ERROR: the merged results differ!")
+		<< (is_rejected ? "" : ", ERROR: the shards of another partition or other settings are merged!") << std::endl;
+	return is_same && is_rejected;
+}
+
+// This function calculates the given length with the results log (see results_log_prefix in estimation_options) in number_of_threads threads 
+// and reads the files back with scan_results_logs and get_histogram_of_estimates. The maximum estimates and the number of diagrams must coincide 
+// with the ones of a calculation without the log, and the histograms must contain all diagrams. Otherwise the function returns false.
+// The files are written to the current directory and removed at the end.
+template<template<int> class diagram_family>
+bool benchmark_results_log(std::ostream& stream_out, int length, int number_of_threads) {
+	estimation_options options;
+	options.number_of_threads = number_of_threads;
+	auto start = std::chrono::steady_clock::now();
+	estimation_result reference = find_worst_diagrams<diagram_family>(length, options);
+	double reference_time = get_seconds_since(start);
+
+	options.results_log_prefix = "benchmark";
+	std::vector<std::string> file_names;
+	for (int i = 0; i < number_of_threads; ++i) {
+		file_names.push_back(options.results_log_prefix + "_" + get_class_name<diagram_family>() + "_" + std::to_string(length) 
+			+ "_thread" + std::to_string(i) + ".log");
+		std::remove(file_names.back().c_str());
+	}
+	start = std::chrono::steady_clock::now();
+	find_worst_diagrams<diagram_family>(length, options);
+	double time = get_seconds_since(start);
+
+	double file_size = 0.;
+	for (const auto& file_name : file_names) {
+		std::ifstream file_in(file_name, std::ios::binary | std::ios::ate);
+		file_size += file_in ? static_cast<double>(file_in.tellg()) : 0.;
+	}
+	start = std::chrono::steady_clock::now();
+	estimation_result result;
+	std::vector<long long> histogram[2];
+	bool is_read = scan_results_logs(file_names, options.number_of_worst_diagrams, result) && get_histogram_of_estimates(file_names, 0.25, histogram);
+	double reading_time = get_seconds_since(start);
+	for (const auto& file_name : file_names)
+		std::remove(file_name.c_str());
+
+	bool is_correct = is_read && result.number_of_diag == reference.number_of_diag && result.value_8 == reference.value_8 
+		&& result.value_limit == reference.value_limit;
+	for (int i = 0; i < 2; ++i)
+		is_correct = is_correct && std::accumulate(histogram[i].begin(), histogram[i].end(), 0ll) == reference.number_of_diag;
+	stream_out
+		<< "Results log, " << get_class_name<diagram_family>() << " of length " << length << ", " << number_of_threads << " threads: "
+		<< std::fixed << std::setprecision(2) << file_size / 1048576. << " MB, calculation " << reference_time << " sec. without the log and " 
+		<< time << " sec. with it, reading " << reading_time << " sec." << (is_correct ? "" : ", ERROR: the results differ!") << std::endl;
+	return is_correct;
+}
+
+// Technical function. It returns the last diagram of every unit of the given length in the order of walk_trough_all_diagrams,
+// i.e. the largest interesting continuation is chosen at every level. These diagrams have the largest symbols. The dead ends are skipped.
+template<class chord_like_type>
+std::vector<std::vector<int>> get_last_diagrams_of_units(int length) {
+	int split_depth = 0;
+	std::vector<std::vector<int>> diagrams;
+	for (const auto& unit : collect_units<chord_like_type>(length, split_depth)) {
+		diagram_prefix prefix(length, chord_like_type::is_pre_ACD, unit.rhs_lhs);
+		prefix.push(unit.new_v);
+		while (prefix.size() < 2 * length) {
+			int last = -1;
+			for (unsigned values = prefix.get_possible_values(); values != 0; values &= values - 1) {
+				int c = diagram_prefix::get_lowest_bit(values);
+				prefix.push(c);
+				if (!prefix.is_not_interesting())
+					last = c;
+				prefix.pop();
+			}
+			if (last < 0)
+				break;
+			prefix.push(last);
+		}
+		if (prefix.size() == 2 * length)
+			diagrams.push_back(prefix.get_symbols());
+	}
+	return diagrams;
+}
+
+// This function writes the last diagram of every unit of the given length (see get_last_diagrams_of_units) and random diagrams
+// (see make_random_descent) to a results log with distinct values and multiplicities and reads them back. The read records must coincide with the written ones, otherwise the function returns false. It is needed for the long
+// diagrams, whose symbols do not fit into 4 bits, since the logs of the calculations in benchmark_results_log are too short for them.
+// The diagrams depend only on the seed. The file is written to the current directory and removed at the end.
+template<class chord_like_type>
+bool benchmark_results_log_records(std::ostream& stream_out, int length, size_t number_of_diagrams, unsigned seed = 1) {
+	int split_depth = 0;
+	std::vector<walk_task> units = collect_units<chord_like_type>(length, split_depth);
+	std::mt19937_64 generator(seed);
+	std::vector<std::vector<int>> diagrams = get_last_diagrams_of_units<chord_like_type>(length);
+	std::vector<int> rhs_lhs;
+	for (size_t i = 0; i < number_of_diagrams && !units.empty(); ++i) {
+		const walk_task& unit = units[std::uniform_int_distribution<size_t>(0, units.size() - 1)(generator)];
+		if (make_random_descent<chord_like_type>(unit, length, generator, rhs_lhs) > 0.)
+			diagrams.push_back(rhs_lhs);
+	}
+
+	std::string file_name = "benchmark_" + get_class_name<chord_like_type>() + "_" + std::to_string(length) + "_records.log";
+	std::remove(file_name.c_str());
+	int max_symbol = 0;
+	{
+		results_log log(file_name);
+		for (size_t i = 0; i < diagrams.size(); ++i) {
+			log.add(diagrams[i], static_cast<double>(i), -static_cast<double>(i), 1 + i % 2);
+			max_symbol = std::max(max_symbol, *std::max_element(diagrams[i].begin(), diagrams[i].end()));
+		}
+	}
+	std::vector<results_log::record> records;
+	bool is_correct = results_log::read(file_name, records) && records.size() == diagrams.size();
+	for (size_t i = 0; is_correct && i < records.size(); ++i)
+		is_correct = records[i].get_diagram() == diagrams[i] && records[i].multiplicity == static_cast<int>(1 + i % 2)
+			&& records[i].value_8 == static_cast<double>(i) && records[i].value_limit == -static_cast<double>(i);
+	std::remove(file_name.c_str());
+
+	stream_out
+		<< "Results log records, " << get_class_name<chord_like_type>() << " of length " << length << ", " << diagrams.size() 
+		<< " diagrams with the symbols up to " << max_symbol << (is_correct ? ": read back correctly" : ": ERROR: the records differ!") << std::endl;
+	return is_correct;
+}
\ No newline at end of file
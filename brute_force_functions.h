@@ -1,13 +1,39 @@
 #pragma once
 #include <set>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <iomanip>
+#include <memory>
 #include <thread>
 #include <sstream>
+#include <fstream>
+#include <iostream>
+#include <ctime>
+#include <stdexcept>
+#include <type_traits>
+#include <functional>
 
 #include "alglib/optimization.h"	// This is a part of ALGLIB library, see https://www.alglib.net/
 
 #include "Technical classes/ACD.h"
 #include "Technical classes/pre_ACD.h"
+#include "Technical classes/work_stealing_pool.h"
+#include "Technical classes/transposition_table.h"
+#include "Technical classes/linear_function_front.h"
+#include "Technical classes/enumeration_progress.h"
+#include "Technical classes/estimation_options.h"
+#include "Technical classes/estimation_result.h"
+#include "Technical classes/shared_maximum.h"
+#include "Technical classes/lp_solver_context.h"
+#include "Technical classes/max_min_solver.h"
+#include "Technical classes/exact_lp_certificate.h"
+#include "Technical classes/diagram_prefix.h"
+#include "Technical classes/periodic_reporter.h"
+#include "Technical classes/results_log.h"
+#include "Technical classes/function_set_cache.h"
+#include "Technical classes/diagram_corpus.h"
+#include "Technical classes/elimination_job.h"
 
 /*
 This file contains the main functions that perform the calculations. 
@@ -16,10 +42,9 @@ complexity. For each of them, we compute the estimate and select a maximum among
 We reduce the brute force by pre-cutting those diagrams that obviously do not give the maximum value.
 */
 
-// Technical function. It returns a string containing the time passed.
-std::string get_time(const std::clock_t& start) {
+// Technical function. It returns a string containing the given time (in seconds).
+std::string get_time(double time) {
 	std::stringstream stream;
-	double time = (double)(clock() - start) / CLOCKS_PER_SEC;
 	stream << std::fixed << std::setprecision(2);
 	std::string time_type(" sec.");
 	if (time > 60) {
@@ -38,22 +63,75 @@ std::string get_time(const std::clock_t& start) {
 	return std::string(stream.str() + time_type);
 }
 
-// Technical function. It writes information into the stream.
+// Technical function. It returns a string containing the CPU time of the process passed since start. Notice: it is the sum over all threads.
+std::string get_time(const std::clock_t& start) {
+	return get_time((double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
+// Technical function. It returns the name of the class used in the output.
+template<class T>
+std::string get_class_name() {
+	return T::get_class_name();
+}
+
+// Technical function. The same for a family of classes, e.g. ACD (the name does not depend on the length).
+template<template<int> class diagram_family>
+std::string get_class_name() {
+	return diagram_family<1>::get_class_name();
+}
+
+// Technical structure. It passes a type to a generic lambda: [](auto tag) { using T = typename decltype(tag)::type; ... }.
 template<class T>
-void make_simple_output(std::ostream& stream_out, int length, int num_of_diag, double max_value_8, double max_value_limit, const std::clock_t& start) {
-	std::string class_name = typeid(T) == typeid(ACD) ? "ACD" : "preACD";
+struct type_tag {
+	using type = T;
+};
+
+// Technical structure. Its function call(length, function) returns function(type_tag<diagram_family<length>>()), 
+// i.e. it chooses the class with the storage of the exact size for the length given at run time.
+// The classes are instantiated for all lengths from 1 to n_max, and a larger length gives an exception.
+template<template<int> class diagram_family, int N = 1>
+struct length_dispatcher {
+	template<class function_type>
+	static auto call(int length, function_type& function) -> decltype(function(type_tag<diagram_family<N>>())) {
+		if (length <= N)
+			return function(type_tag<diagram_family<N>>());
+		return length_dispatcher<diagram_family, N + 1>::call(length, function);
+	}
+};
+
+template<template<int> class diagram_family>
+struct length_dispatcher<diagram_family, n_max> {
+	template<class function_type>
+	static auto call(int length, function_type& function) -> decltype(function(type_tag<diagram_family<n_max>>())) {
+		if (length > n_max)
+			throw std::invalid_argument("The length should not be greater than n_max = " + std::to_string(n_max));
+		return function(type_tag<diagram_family<n_max>>());
+	}
+};
+
+// Technical function. It writes information into the stream. The time taken is given in seconds.
+template<template<int> class diagram_family>
+void make_simple_output(std::ostream& stream_out, int length, long long num_of_diag, double max_value_8, double max_value_limit, double time) {
+	std::string class_name = get_class_name<diagram_family>();
 	stream_out
 		<< "Number of " << class_name << " of length  " << length
 		<< " considered is " << num_of_diag
 		<< ". It takes "
-		<< get_time(start) << " Worst values are "
+		<< get_time(time) << " Worst values are "
 		<< std::fixed << std::setprecision(8)
 		<< max_value_8 / 8. + 1. << " and " << max_value_limit + 1. << std::endl;
 }
 
+// Technical function. It writes information into the stream.
+template<template<int> class diagram_family>
+void make_simple_output(std::ostream& stream_out, int length, long long num_of_diag, double max_value_8, double max_value_limit, const std::clock_t& start) {
+	make_simple_output<diagram_family>(stream_out, length, num_of_diag, max_value_8, max_value_limit, (double)(clock() - start) / CLOCKS_PER_SEC);
+}
+
 // Check if (pre)ACD constructed from a given vector would give a small estimate. There are several possible conditions: 
 // (1) the number of chords is greater than 3, and there is a chord of length 1;
 // (2) the number of chords is greater than 5, and we can eliminate all chords without passing through a chord that has already been eliminated.
+// The enumeration of diagrams uses diagram_prefix, which gives the same result without rescanning the vector. This function is the reference for it.
 template<class T>
 bool not_interesting(const std::vector<int>& chords, int required_k) {
 	if (required_k < 4)
@@ -62,7 +140,7 @@ bool not_interesting(const std::vector<int>& chords, int required_k) {
 	// Note that preACD is not a cyclic string.
 	for (int i = 1; i < chords.size(); ++i)
 		if ((chords[i] == chords[i - 1]) 
-			&& ((typeid(T) == typeid(ACD)) || (typeid(T) == typeid(pre_ACD)) && (i != required_k)))
+			&& (!T::is_pre_ACD || (i != required_k)))
 			return true;
 	// Check if we can eliminate all chords without passing through a chord that has already been eliminated.
 	// Note that we only need to check the last k chords, as the previous sequences have already been checked.
@@ -76,31 +154,204 @@ bool not_interesting(const std::vector<int>& chords, int required_k) {
 }
 
 // This function recursively constructs a set of all linear functions obtained after number_of_moves consecutive eliminations. 
+// Only non-dominated functions are kept, see linear_function_front.
+// The states that have already been expanded are stored in visited_states, and their subtrees are not expanded again.
 template <class chord_like_type>
-void all_linear_functions_chord_diagram(chord_like_type start, std::set<linear_function>& results, int number_of_moves, bool is_limit_case) {
+void all_linear_functions_chord_diagram(chord_like_type start, linear_function_front<typename chord_like_type::function_type>& results, int number_of_moves, bool is_limit_case, transposition_table& visited_states) {
 	if (start.get_number_of_increases() == number_of_moves) {
 		results.insert(start.get_increaser());
 		return;
 	}
+	// Check if the same state has been reached by another order of eliminations.
+	std::vector<int> state_key;
+	start.get_state_key(state_key);
+	if (!visited_states.insert(state_key))
+		return;
 	// Considering all the possible ways to make a turn.
 	chord_like_type start_copy(start);
 	auto all_turns = start.get_all_possible_turns();
 	for (auto ind : all_turns) {
 		start_copy = start;
 		start_copy.eliminate_turn(ind);
-		all_linear_functions_chord_diagram(start_copy, results, number_of_moves, is_limit_case);
+		all_linear_functions_chord_diagram(start_copy, results, number_of_moves, is_limit_case, visited_states);
 	}
 	// Try to eliminate a chord from the left.
 	start_copy = start;
 	if (start_copy.eliminate_from_side(false, is_limit_case))
-		all_linear_functions_chord_diagram(start_copy, results, number_of_moves, is_limit_case);
+		all_linear_functions_chord_diagram(start_copy, results, number_of_moves, is_limit_case, visited_states);
 	// Try to eliminate a chord from the right.
 	if (start.eliminate_from_side(true, is_limit_case))
-		all_linear_functions_chord_diagram(start, results, number_of_moves, is_limit_case);
+		all_linear_functions_chord_diagram(start, results, number_of_moves, is_limit_case, visited_states);
+}
+
+// Technical function, see below.
+template <class chord_like_type>
+void splice_cached_functions(chord_like_type& start, linear_function_front<typename chord_like_type::function_type>& results, int number_of_moves,
+	bool is_limit_case, function_set_cache& cache);
+
+// This function is the same as all_linear_functions_chord_diagram, but the transformations are applied to one object and then reverted 
+// (see ACD_in_place and pre_ACD_in_place), so the states are not copied. state_key is a buffer for the encodings of the states.
+// If cache is not null, the functions below the states with at most cache->get_max_number_of_weights() weights are taken from it (see splice_cached_functions).
+template <class chord_like_type>
+void all_linear_functions_in_place(chord_like_type& start, linear_function_front<typename chord_like_type::function_type>& results, int number_of_moves, 
+	bool is_limit_case, transposition_table& visited_states, std::vector<int>& state_key, function_set_cache* cache = nullptr) {
+	if (start.get_number_of_increases() == number_of_moves) {
+		results.insert(start.get_increaser());
+		return;
+	}
+	// Check if the same state has been reached by another order of eliminations.
+	start.get_state_key(state_key);
+	if (!visited_states.insert(state_key))
+		return;
+	if (cache != nullptr && start.get_number_of_weights() <= cache->get_max_number_of_weights()) {
+		splice_cached_functions(start, results, number_of_moves, is_limit_case, *cache);
+		return;
+	}
+	// Considering all the possible ways to make a turn.
+	auto all_turns = start.get_all_possible_turns();
+	for (auto ind : all_turns) {
+		start.eliminate_turn(ind);
+		all_linear_functions_in_place(start, results, number_of_moves, is_limit_case, visited_states, state_key, cache);
+		start.undo();
+	}
+	// Try to eliminate a chord from the left and from the right.
+	for (bool is_right : { false, true }) {
+		if (start.eliminate_from_side(is_right, is_limit_case)) {
+			all_linear_functions_in_place(start, results, number_of_moves, is_limit_case, visited_states, state_key, cache);
+			start.undo();
+		}
+	}
+}
+
+// Technical function. It adds to results the functions obtained by all eliminations from the current state of start, using the set of vectors
+// of the residual diagram stored in cache (see function_set_cache). If the set is not stored yet, it is constructed once by all_linear_functions_in_place 
+// with the weights replaced by the variables 1, ..., r and the increaser replaced by zero, and it is added to the cache.
+// The state of start is restored at the end.
+template <class chord_like_type>
+void splice_cached_functions(chord_like_type& start, linear_function_front<typename chord_like_type::function_type>& results, int number_of_moves,
+	bool is_limit_case, function_set_cache& cache) {
+	using function_type = typename chord_like_type::function_type;
+	thread_local std::vector<int> residual_key;
+	thread_local std::vector<function_type> weights;
+	int number_of_weights = start.get_number_of_weights();
+	start.get_residual_key(residual_key);
+	residual_key.push_back(number_of_moves - start.get_number_of_increases());
+	residual_key.push_back(is_limit_case);
+
+	weights.resize(number_of_weights + 1);
+	const std::vector<int>* functions = cache.find(residual_key);
+	if (functions == nullptr) {
+		for (int l = 0; l < number_of_weights; ++l)
+			weights[l] = function_type(l + 1, 1, number_of_weights + 1);
+		weights[number_of_weights] = function_type(0, 0, number_of_weights + 1);
+	}
+	// Now start has the variables instead of its weights (if the set is not found), and weights contains its own weights and the increaser.
+	start.swap_weights(weights);
+	if (functions == nullptr) {
+		// The sets of the residual diagrams are constructed without the cache, so the containers are not used recursively.
+		thread_local linear_function_front<function_type> symbolic_results;
+		thread_local transposition_table symbolic_states;
+		thread_local std::vector<int> state_key;
+		symbolic_results.clear();
+		symbolic_states.clear();
+		all_linear_functions_in_place(start, symbolic_results, number_of_moves, is_limit_case, symbolic_states, state_key);
+		std::vector<int> new_functions;
+		new_functions.reserve(symbolic_results.size() * (number_of_weights + 1));
+		for (const auto& p : symbolic_results)
+			for (int i = 0; i <= number_of_weights; ++i)
+				new_functions.push_back(p.get_coef_under_variable(i));
+		functions = cache.insert(residual_key, std::move(new_functions));
+	}
+	for (auto vector = functions->cbegin(); vector != functions->cend(); vector += number_of_weights + 1) {
+		function_type f = weights[number_of_weights];
+		f += vector[0];
+		for (int l = 0; l < number_of_weights; ++l)
+			if (vector[l + 1] != 0)
+				f += vector[l + 1] * weights[l];
+		results.insert(f);
+	}
+	start.swap_weights(weights);
+}
+
+// This function is the same as all_linear_functions_in_place, but the tree of eliminations is traversed together with other threads (see elimination_job).
+// At the states worth sharing, all transformations but the first are applied to copies of the state, which are given to the job, 
+// and only the first one is expanded here. Below the states with fewer than job.min_moves_to_share remaining eliminations nothing is shared.
+// The number of shared states is added to stat.
+template <class chord_like_type>
+void all_linear_functions_shared(chord_like_type& start, linear_function_front<typename chord_like_type::function_type>& results, 
+	transposition_table& visited_states, std::vector<int>& state_key, elimination_job<chord_like_type>& job, estimation_statistics& stat) {
+	if (job.number_of_moves - start.get_number_of_increases() < job.min_moves_to_share) {
+		all_linear_functions_in_place(start, results, job.number_of_moves, job.is_limit_case, visited_states, state_key, job.cache);
+		return;
+	}
+	// Check if the same state has been reached by another order of eliminations.
+	start.get_state_key(state_key);
+	if (!visited_states.insert(state_key))
+		return;
+	if (job.cache != nullptr && start.get_number_of_weights() <= job.cache->get_max_number_of_weights()) {
+		splice_cached_functions(start, results, job.number_of_moves, job.is_limit_case, *job.cache);
+		return;
+	}
+	bool is_shared = job.is_worth_sharing(start), is_first = true;
+	auto expand = [&]() {
+		if (is_shared && !is_first) {
+			job.share(start);
+			++stat.number_of_shared_states;
+		}
+		else
+			all_linear_functions_shared(start, results, visited_states, state_key, job, stat);
+		is_first = false;
+	};
+	// Considering all the possible ways to make a turn.
+	auto all_turns = start.get_all_possible_turns();
+	for (auto ind : all_turns) {
+		start.eliminate_turn(ind);
+		expand();
+		start.undo();
+	}
+	// Try to eliminate a chord from the left and from the right.
+	for (bool is_right : { false, true }) {
+		if (start.eliminate_from_side(is_right, job.is_limit_case)) {
+			expand();
+			start.undo();
+		}
+	}
+}
+
+// This function expands the states shared by another thread until there are none left, and merges the functions into the job (see elimination_job).
+// It is the task given to the pool by job.call_helper. The thread has its own containers for it, so it may be called between any two diagrams.
+template <class chord_like_type>
+void expand_shared_states(elimination_job<chord_like_type>& job, estimation_statistics& stat) {
+	thread_local linear_function_front<typename chord_like_type::function_type> results;
+	thread_local transposition_table visited_states;
+	thread_local std::vector<int> state_key;
+	thread_local std::vector<chord_like_type> state;
+	visited_states.clear();
+	while (job.take(state)) {
+		results.clear();
+		{
+			stage_timer timer(job.measure_stage_times ? &stat.elimination_time : nullptr);
+			all_linear_functions_shared(state.back(), results, visited_states, state_key, job, stat);
+		}
+		++stat.number_of_helped_states;
+		job.finish(&results);
+	}
+	visited_states.add_statistics(stat);
+}
+
+// This function constructs the set of linear functions of the limit case from the set for m = 8 obtained by the same eliminations.
+// The transformations in both cases are the same, only the constant terms (the added crossings) are not added in the limit case, and 
+// they never change other coefficients. So the function of the limit case is the linear part of the function for m = 8 after the same eliminations.
+// If f is dominated by g, then the linear part of f is dominated by the linear part of g, so it is enough to filter the front for m = 8.
+template<class function_type>
+void get_limit_case_functions(const linear_function_front<function_type>& results_8, linear_function_front<function_type>& results_limit) {
+	for (const auto& p : results_8)
+		results_limit.insert(p.get_linear_part());
 }
 
 // This function returns the solution to the linear programming problem. See details inside.
-double create_solver(const std::set<linear_function>& all_linear_functions, bool is_limit_case) {
+template<class function_type>
+double create_solver(const linear_function_front<function_type>& all_linear_functions, bool is_limit_case) {
 	/*
 	We solve the following optimization problem:
 	-x[n+1] -> min
@@ -127,31 +378,31 @@ double create_solver(const std::set<linear_function>& all_linear_functions, bool
 	alglib::real_1d_array a_lower;	// Lower bounds for each inequality
 	alglib::real_1d_array a_upper;	// Upper bounds for each inequality
 
-	double temp[2 * n_max + 3];	//Technical array, used to specify all other objects.
+	std::vector<double> temp(num_of_variables);	//Technical array, used to specify all other objects.
 
 	// Set lower bounds for variables. 
 	// In our case x[0] = 1 (it is a constant), x[i]=>0 (for i=1,2,...,n) and x[n+1] > -inf.
-	std::fill_n(temp, num_of_variables, 0.);
-	bounds_lower.setcontent(num_of_variables, temp);
+	std::fill_n(temp.begin(), num_of_variables, 0.);
+	bounds_lower.setcontent(num_of_variables, temp.data());
 	bounds_lower[0] = 1;
 	bounds_lower[num_of_variables - 1] = alglib::fp_neginf;
 
 	// Set upper bounds for variables. 
 	// In our case x[0] = 1 (it is a constant), x[i]<=1 (for i=1,2,...,n) and x[n+1] < inf.
-	std::fill_n(temp, num_of_variables, m);
-	bounds_upper.setcontent(num_of_variables, temp);
+	std::fill_n(temp.begin(), num_of_variables, m);
+	bounds_upper.setcontent(num_of_variables, temp.data());
 	bounds_upper[0] = 1;
 	bounds_upper[num_of_variables - 1] = alglib::fp_posinf;
 
 	// Set minimization function coefficients.
 	// In our case its -1*x[n+1].
-	std::fill_n(temp, num_of_variables, 0.);
-	cost.setcontent(num_of_variables, temp);
+	std::fill_n(temp.begin(), num_of_variables, 0.);
+	cost.setcontent(num_of_variables, temp.data());
 	cost[num_of_variables - 1] = -1;
 
 	// Scales is a technical function, see https://www.alglib.net/optimization/scaling.php
-	std::fill_n(temp, num_of_variables, 1);
-	scales.setcontent(num_of_variables, temp);
+	std::fill_n(temp.begin(), num_of_variables, 1);
+	scales.setcontent(num_of_variables, temp.data());
 	scales[num_of_variables - 1] = 1;
 
 	// Set bounds for main inequalities.
@@ -201,37 +452,273 @@ double create_solver(const std::set<linear_function>& all_linear_functions, bool
 	return solution[num_of_variables - 1];
 }
 
-// This function creates the linear programming problem for a (pre)ACD and returns its solution.
-template <class chord_like_type>
-double get_estimates_for_one_chord_diagram(const chord_like_type& s, int num_of_eleminations, bool is_limit_case) {
-	std::set<linear_function> results;
-	all_linear_functions_chord_diagram(s, results, num_of_eleminations, is_limit_case);
-	return create_solver(results, is_limit_case);
+// Technical function. It returns the LP solver context of the current thread, see lp_solver_context.
+lp_solver_context& get_thread_lp_solver_context() {
+	thread_local lp_solver_context context;
+	return context;
 }
 
-// This function recursively traverses all possible interesting (pre)ACD starting with rhs_lhs by adding symbol new_v.
-template<class chord_like_type>
-void walk_trough_all_diagrams(std::vector<int>& rhs_lhs, double& value_8, double& value_limit, int& number_of_diag, int length, int new_v) {
-	// Add new symbol.
-	rhs_lhs.push_back(new_v);
-	// Check if it can result in an interesting (pre)ACD
-	if (not_interesting<chord_like_type>(rhs_lhs, length)) {
-		rhs_lhs.pop_back();
-		return;
+// Technical function. It returns the max-min solver of the current thread, see max_min_solver.
+max_min_solver& get_thread_max_min_solver() {
+	thread_local max_min_solver solver;
+	return solver;
+}
+
+// Technical function. It returns the exact certificate of the current thread, see exact_lp_certificate.
+exact_lp_certificate& get_thread_exact_lp_certificate() {
+	thread_local exact_lp_certificate certificate;
+	return certificate;
+}
+
+// Technical functions. They return the containers of the current thread used for the LP of one diagram (a set of functions for each case). 
+// They are cleared, but not freed, between diagrams, so their memory is allocated only a few times for the whole calculation.
+template<class function_type>
+linear_function_front<function_type>& get_thread_function_front(bool is_limit_case = false) {
+	thread_local linear_function_front<function_type> results[2];
+	return results[is_limit_case];
+}
+
+transposition_table& get_thread_transposition_table() {
+	thread_local transposition_table visited_states;
+	return visited_states;
+}
+
+// This function returns an upper bound for the solution of the linear programming problem (see create_solver). 
+// Since the solution is not greater than the maximum of every single linear function over the feasible set, and the coefficients are non-negative, 
+// the bound is the minimum over all functions of f[j](0) + m * (the maximal coefficient of f[j]).
+template<class function_type>
+double get_upper_bound(const linear_function_front<function_type>& all_linear_functions, bool is_limit_case) noexcept {
+	double m = (is_limit_case) ? 1. : 8.;
+	double upper_bound = alglib::fp_posinf;
+	for (const auto& p : all_linear_functions) {
+		int max_coef = 0;
+		for (int i_var = 1; i_var < p.get_number_of_variables(); ++i_var)
+			max_coef = std::max(max_coef, p.get_coef_under_variable(i_var));
+		upper_bound = std::min(upper_bound, p.get_coef_under_variable(0) + m * max_coef);
 	}
-	// Check that the size of rhs_lhs is sufficient to create the (pre)ACD.
-	if (rhs_lhs.size() == 2 * length) {
-		chord_like_type new_chord_diag = chord_like_type(rhs_lhs);
-		++number_of_diag;
+	return upper_bound;
+}
 
-		value_8 = std::max(value_8, get_estimates_for_one_chord_diagram<chord_like_type>(new_chord_diag, length, false));
-		value_limit = std::max(value_limit, get_estimates_for_one_chord_diagram<chord_like_type>(new_chord_diag, length, true));
+// The LP is skipped only if its upper bound is less than the threshold by this relative margin, which is much larger than the errors of the LP solver.
+// So the skipped diagram could not change the maximum even by rounding errors.
+constexpr double branch_and_bound_margin = 1e-9;
 
-		rhs_lhs.pop_back();
-		return;
+// A function is added to the LP of the row generation if its value at the solution is less than the solution by this relative margin
+// (see solve_by_row_generation). It is much larger than the errors of the LP solvers.
+constexpr double row_generation_margin = 1e-9;
+
+// This function solves the linear programming problem for the given set of linear functions by row generation (lazy constraint generation):
+// the LP is solved for a small subset of the functions, all functions are evaluated at its solution x, the functions less than the solution
+// at x are added to the subset, and so on. The solution for a subset is not less than the one for all functions, so if no function
+// is less than it at x, then x is optimal for all functions. The subset grows every time, so the process stops.
+// The optimum is determined by at most n + 1 functions, and the subset starts with the functions which are minimal at the vertices of 
+// the feasible set (0 and m * e[i]) and at its centre. Usually a few rounds are enough, and the LPs are much smaller than the whole set.
+// The solver is max_min_solver or lp_solver_context. The returned value is the minimum of all functions at the final x, which is 
+// the point given by solver.get_solution(). The number of rounds and the size of the last subset are added to stat.
+template <class solver_type, class function_type>
+double solve_by_row_generation(solver_type& solver, const linear_function_front<function_type>& all_linear_functions, bool is_limit_case, 
+	estimation_statistics& stat) {
+	double m = (is_limit_case) ? 1. : 8.;
+	int num_of_variables = all_linear_functions.cbegin()->get_number_of_variables();
+	size_t num_of_functions = all_linear_functions.size();
+	const function_type* functions = &*all_linear_functions.cbegin();
+	thread_local std::vector<function_type> rows;
+	thread_local std::vector<char> is_in_rows;
+	rows.clear();
+	is_in_rows.assign(num_of_functions, 0);
+	auto add_row = [&](size_t j) {
+		if (!is_in_rows[j]) {
+			is_in_rows[j] = 1;
+			rows.push_back(functions[j]);
+		}
+	};
+
+	// The seed: the minimal functions at 0, at m * e[i] and at the centre m / n * (e[1] + ... + e[n]).
+	for (int vertex = 0; vertex <= num_of_variables; ++vertex) {
+		size_t best = 0;
+		double best_value = 0.;
+		for (size_t j = 0; j < num_of_functions; ++j) {
+			double value = functions[j].get_coef_under_variable(0);
+			if (vertex == num_of_variables) {
+				for (int i = 1; i < num_of_variables; ++i)
+					value += m / (num_of_variables - 1) * functions[j].get_coef_under_variable(i);
+			}
+			else if (vertex > 0)
+				value += m * functions[j].get_coef_under_variable(vertex);
+			if (j == 0 || value < best_value) {
+				best = j;
+				best_value = value;
+			}
+		}
+		add_row(best);
+	}
+
+	double min_value;
+	while (true) {
+		++stat.number_of_row_generation_rounds;
+		double value = solver.solve(rows, is_limit_case);
+		const auto& x = solver.get_solution();
+		double threshold = value - row_generation_margin * std::max(1., std::abs(value));
+		size_t old_size = rows.size();
+		min_value = value;
+		for (size_t j = 0; j < num_of_functions; ++j) {
+			double f = functions[j].get_coef_under_variable(0);
+			for (int i = 1; i < num_of_variables; ++i)
+				f += functions[j].get_coef_under_variable(i) * x[i];
+			min_value = std::min(min_value, f);
+			if (f < threshold)
+				add_row(j);
+		}
+		// The solution is optimal, or the only violated functions are already in the LP (by the rounding errors of the solver).
+		if (rows.size() == old_size)
+			break;
+	}
+	stat.number_of_generated_rows += rows.size();
+	return min_value;
+}
+
+// This function solves the linear programming problem for the given set of linear functions and returns its solution. The sizes of the LP are added to stat.
+// If the upper bound of the solution (see get_upper_bound) is less than threshold (e.g. the maximum found so far), the LP is not solved 
+// and the function returns -1. The estimates are not negative, so the default threshold never skips an LP.
+// If measure_stage_times is true, the time of the LP solver is added to stat.
+// The LP is solved by max_min_solver or, if use_alglib_lp_solver is true, by lp_solver_context. Both give the same result as create_solver.
+// If use_row_generation is true, the solver gets only a part of the functions, see solve_by_row_generation.
+// If solution is not null, the optimal values of x[1], ..., x[n] are written to it (nothing if the LP is skipped).
+template <class function_type>
+double get_estimate_for_functions(const linear_function_front<function_type>& results, bool is_limit_case, estimation_statistics& stat, 
+	double threshold = -1., bool measure_stage_times = false, bool use_alglib_lp_solver = false, bool use_row_generation = false, 
+	std::vector<double>* solution = nullptr) {
+	if (solution != nullptr)
+		solution->clear();
+	if (threshold >= 0. && get_upper_bound(results, is_limit_case) < threshold - branch_and_bound_margin * std::max(1., threshold)) {
+		++stat.number_of_skipped_lp;
+		return -1.;
+	}
+	++stat.number_of_lp;
+	stat.number_of_linear_functions += results.get_number_of_offered_functions();
+	stat.number_of_lp_rows += results.size();
+
+	// The problem is solved by the persistent solver of the thread.
+	auto solve = [&](auto& solver) {
+		long long number_of_iterations = solver.get_number_of_iterations();
+		double value;
+		{
+			stage_timer timer(measure_stage_times ? &stat.lp_time : nullptr);
+			value = use_row_generation ? solve_by_row_generation(solver, results, is_limit_case, stat) : solver.solve(results, is_limit_case);
+		}
+		stat.number_of_lp_iterations += solver.get_number_of_iterations() - number_of_iterations;
+		if (solution != nullptr) {
+			// The solution point is x[0] = 1, x[1], ..., x[n] and the value.
+			const auto& x = solver.get_solution();
+			for (int i = 1; i < results.cbegin()->get_number_of_variables(); ++i)
+				solution->push_back(x[i]);
+		}
+		return value;
+	};
+	return use_alglib_lp_solver ? solve(get_thread_lp_solver_context()) : solve(get_thread_max_min_solver());
+}
+
+// The terms of the certified fractions are less than this number, so they are compared exactly (see certified_estimate).
+constexpr long long max_certified_term = 2147483647;
+
+// This function finds the exact estimate for the set of linear functions: the LP is solved in floating point by max_min_solver of the thread
+// (whichever solver gave the estimate), and its optimal basis is proved optimal in exact arithmetic, see exact_lp_certificate.
+// It returns true and writes the estimate as an irreducible fraction if the basis is optimal and the terms are less than max_certified_term.
+// Otherwise nothing is proved (it is rare: the rounding errors must lead the solver to a wrong basis). The counters are added to stat, 
+// and if measure_stage_times is true, the time is added to the time of the LP solver.
+template <class function_type>
+bool certify_estimate(const linear_function_front<function_type>& results, bool is_limit_case, estimation_statistics& stat, 
+	long long& numerator, long long& denominator, bool measure_stage_times = false) {
+	stage_timer timer(measure_stage_times ? &stat.lp_time : nullptr);
+	thread_local std::vector<int> rows, coordinates;
+	max_min_solver& solver = get_thread_max_min_solver();
+	solver.solve(results, is_limit_case);
+	solver.get_optimal_basis(rows, coordinates);
+	exact_lp_certificate& certificate = get_thread_exact_lp_certificate();
+	++stat.number_of_certified_lp;
+	if (!certificate.check(results, is_limit_case ? 1 : 8, rows, coordinates) || !certificate.get_value(numerator, denominator, max_certified_term)) {
+		++stat.number_of_failed_certificates;
+		return false;
 	}
+	return true;
+}
+
+// This function solves the LPs for the same set of linear functions (of the case m = 8) and the sizes of the starting curve curve_sizes, 
+// i.e. with x[1] + ... + x[n] <= m for every m in curve_sizes (see max_min_solver::solve_for_curve_size), and writes the solutions to values.
+// The functions do not depend on m, so they are constructed once, and every LP starts from the optimal basis of the previous one.
+// So the sizes should be sorted, then the neighbouring problems are close. The number of LPs and iterations are added to stat.
+template <class function_type>
+void solve_for_curve_sizes(const linear_function_front<function_type>& results, const std::vector<double>& curve_sizes, std::vector<double>& values, 
+	estimation_statistics& stat, bool measure_stage_times = false) {
+	stage_timer timer(measure_stage_times ? &stat.lp_time : nullptr);
+	max_min_solver& solver = get_thread_max_min_solver();
+	long long number_of_iterations = solver.get_number_of_iterations();
+	values.clear();
+	for (size_t i = 0; i < curve_sizes.size(); ++i)
+		values.push_back(solver.solve_for_curve_size(results, curve_sizes[i], i > 0));
+	stat.number_of_curve_size_lp += curve_sizes.size();
+	stat.number_of_curve_size_iterations += solver.get_number_of_iterations() - number_of_iterations;
+}
+
+// This function constructs the sets of linear functions of a (pre)ACD for both cases, m = 8 and the limit case, by one traversal of the tree of eliminations
+// (see get_limit_case_functions). The sets are written to the containers of the thread, see get_thread_function_front.
+// The diagram s is given by a class with transformations applied in place (see all_linear_functions_in_place), and it is restored at the end.
+// The counters of the transposition table are added to stat, and if measure_stage_times is true, the time of the elimination too.
+// If job is not null, the tree is shared with other threads (see all_linear_functions_shared), and this thread expands the remaining shared states 
+// after its own part (without sharing them again) and waits for the other ones. The cache of job is used then, and the result is the same.
+template <class chord_like_type>
+void all_linear_functions_for_both_cases(chord_like_type& s, int num_of_eleminations, estimation_statistics& stat, bool measure_stage_times = false, 
+	function_set_cache* cache = nullptr, elimination_job<chord_like_type>* job = nullptr) {
+	using function_type = typename chord_like_type::function_type;
+	auto& results_8 = get_thread_function_front<function_type>(false);
+	auto& results_limit = get_thread_function_front<function_type>(true);
+	transposition_table& visited_states = get_thread_transposition_table();
+	thread_local std::vector<int> state_key;
+	results_8.clear();
+	results_limit.clear();
+	visited_states.clear();
+	stage_timer timer(measure_stage_times ? &stat.elimination_time : nullptr);
+	if (job == nullptr)
+		all_linear_functions_in_place(s, results_8, num_of_eleminations, false, visited_states, state_key, cache);
+	else {
+		all_linear_functions_shared(s, results_8, visited_states, state_key, *job, stat);
+		// The remaining states are expanded here without sharing them again, and the ones taken by other threads are waited for.
+		thread_local std::vector<chord_like_type> state;
+		while (job->wait_and_take(state)) {
+			all_linear_functions_in_place(state.back(), results_8, num_of_eleminations, false, visited_states, state_key, job->cache);
+			job->finish();
+		}
+		job->merge_results(results_8);
+	}
+	get_limit_case_functions(results_8, results_limit);
+	visited_states.add_statistics(stat);
+}
 
-	// Find all possible ways to add another symbol to rhs_lhs.
+// This function creates the linear programming problem for a (pre)ACD in one of the cases and returns its solution, see get_estimate_for_functions.
+// The diagram s is given by a class with transformations applied in place (see all_linear_functions_in_place), and it is restored at the end.
+// The counters of the transposition table are added to stat, and if measure_stage_times is true, the time of the elimination too.
+// Notice: if both estimates are needed, all_linear_functions_for_both_cases traverses the eliminations only once.
+template <class chord_like_type>
+double get_estimates_for_one_chord_diagram(chord_like_type& s, int num_of_eleminations, bool is_limit_case, estimation_statistics& stat, 
+	double threshold = -1., bool measure_stage_times = false, bool use_alglib_lp_solver = false, bool use_row_generation = false, 
+	std::vector<double>* solution = nullptr) {
+	auto& results = get_thread_function_front<typename chord_like_type::function_type>(is_limit_case);
+	transposition_table& visited_states = get_thread_transposition_table();
+	thread_local std::vector<int> state_key;
+	results.clear();
+	visited_states.clear();
+	{
+		stage_timer timer(measure_stage_times ? &stat.elimination_time : nullptr);
+		all_linear_functions_in_place(s, results, num_of_eleminations, is_limit_case, visited_states, state_key);
+	}
+	visited_states.add_statistics(stat);
+	return get_estimate_for_functions(results, is_limit_case, stat, threshold, measure_stage_times, use_alglib_lp_solver, use_row_generation, solution);
+}
+
+// Technical function. It finds all possible ways to add another symbol to rhs_lhs. 
+// The enumeration of diagrams uses diagram_prefix, which gives the same values without rescanning the vector. This function is the reference for it.
+template<class chord_like_type>
+std::set<int> get_possible_values(const std::vector<int>& rhs_lhs, int length) {
 	std::set<int> possible_values;
 	int max_v = -1;
 	for (auto c : rhs_lhs) {
@@ -242,104 +729,740 @@ void walk_trough_all_diagrams(std::vector<int>& rhs_lhs, double& value_8, double
 			possible_values.erase(iter_c);
 		max_v = std::max(c, max_v);
 	}
-	if ((max_v < length) || typeid(chord_like_type) == typeid(pre_ACD)) 
+	if ((max_v < length) || chord_like_type::is_pre_ACD) 
 		possible_values.insert(max_v + 1);
-	
-	for (const auto& c : possible_values) 
-		walk_trough_all_diagrams< chord_like_type>(rhs_lhs, value_8, value_limit, number_of_diag, length, c);
-	rhs_lhs.pop_back();
+	return possible_values;
 }
 
-// This is the main function for finding estimates. It returns the total number of traversed (pre)ACD.
+// Technical structure. A task for the thread pool: the subtree of all (pre)ACD starting with rhs_lhs followed by new_v.
+// It is a part of the unit with the given index, see collect_units.
+// If the diagrams are read from a corpus, the task is the range [first_record, end_record) of its records instead.
+// If shared_states is set, the task is to help another thread with the eliminations of its diagram (see elimination_job), and it does not belong to a unit.
+struct walk_task {
+	std::vector<int> rhs_lhs;
+	int new_v = 1;
+	int unit = 0;
+	long long first_record = 0;
+	long long end_record = 0;
+	std::function<void(estimation_statistics&)> shared_states = nullptr;
+};
+
+// Technical structure. The results of the traversal of a part of the (pre)ACD tree, e.g. obtained by one of the threads. 
+// The alignment keeps the results of different threads in different cache lines.
+struct alignas(64) walk_result {
+	estimation_result estimate;		// The maximum estimates, the corresponding diagrams and the number of diagrams traversed.
+	estimation_statistics stat;
+	results_log* log = nullptr;		// If it is not null, the estimates of every diagram are written to it.
+	work_stealing_pool<walk_task>* pool = nullptr;	// If it is not null, the eliminations of large diagrams can be shared with its idle threads 
+	int worker = 0;									// (see min_moves_to_share in estimation_options). worker is the index of the current thread.
+};
+
+// Technical structure. The settings and the data shared by all threads traversing the tree of diagrams.
+struct walk_context {
+	estimation_options options;
+	shared_maximum best_value_8;		// The maximum estimates found so far by all threads. They are used to skip LPs, see use_branch_and_bound.
+	shared_maximum best_value_limit;
+	std::atomic<long long> number_of_diagrams;	// The number of diagrams processed so far by all threads. It is used to report the progress.
+	function_set_cache* residual_cache = nullptr;	// If it is not null, the sets of functions of small residual diagrams are taken from it.
+
+	explicit walk_context(const estimation_options& _options) : options(_options), number_of_diagrams(0) {}
+};
+
+// Technical function. It creates the job for sharing the eliminations of a diagram (for m = 8) with the idle threads of the pool, see elimination_job. 
+// The help is asked by adding tasks to the queue of the given worker. The tasks keep the job alive, while the job keeps only a weak pointer 
+// to itself for them, so it is freed when the owner and the last task are done.
+template<class chord_like_type>
+std::shared_ptr<elimination_job<chord_like_type>> make_elimination_job(work_stealing_pool<walk_task>& pool, int worker, int number_of_moves, 
+	int min_moves_to_share, function_set_cache* cache = nullptr, bool measure_stage_times = false) {
+	using job_type = elimination_job<chord_like_type>;
+	auto job = std::make_shared<job_type>(number_of_moves, false, min_moves_to_share, cache, measure_stage_times);
+	work_stealing_pool<walk_task>* pool_pointer = &pool;
+	std::weak_ptr<job_type> weak_job = job;
+	job->is_hungry = [pool_pointer]() { return pool_pointer->is_hungry(); };
+	job->call_helper = [pool_pointer, worker, weak_job]() {
+		walk_task task;
+		std::shared_ptr<job_type> shared_job = weak_job.lock();
+		task.shared_states = [shared_job](estimation_statistics& stat) { expand_shared_states(*shared_job, stat); };
+		pool_pointer->push(worker, std::move(task));
+	};
+	return job;
+}
+
+// Technical function. The mirror image of a (pre)ACD (i.e. the reversed rhs_lhs, which is the preACD with lhs and rhs swapped) 
+// gives the same estimates, and it is interesting if and only if the original diagram is interesting.
+// The function returns 0 if the mirror image, with chords renamed in order of their first appearance, is lexicographically smaller than rhs_lhs.
+// Otherwise rhs_lhs is the canonical representative and the function returns the number of distinct diagrams it represents (1 or 2).
+// Notice: the mirror image starts with the last symbols of rhs_lhs, so the check can be done only when the whole diagram is constructed.
+int get_symmetry_orbit_size(const std::vector<int>& rhs_lhs) {
+	std::vector<int> new_names(rhs_lhs.size() + 2, 0);
+	int last_name = 0;
+	for (size_t i = 0; i < rhs_lhs.size(); ++i) {
+		int c = rhs_lhs[rhs_lhs.size() - 1 - i];
+		if (new_names[c] == 0)
+			new_names[c] = ++last_name;
+		if (new_names[c] != rhs_lhs[i])
+			return new_names[c] < rhs_lhs[i] ? 0 : 2;
+	}
+	return 1;
+}
+
+// Technical function. It computes both estimates for the (pre)ACD given by rhs_lhs and updates the maximums.
+template<class chord_like_type>
+void process_diagram(const std::vector<int>& rhs_lhs, walk_result& result, int length, walk_context& context) {
+	++result.stat.number_of_diagrams;
+	context.number_of_diagrams.fetch_add(1, std::memory_order_relaxed);
+	// Skip the diagram if its mirror image is considered instead.
+	int multiplicity = 1;
+	if (context.options.use_symmetry_reduction) {
+		multiplicity = get_symmetry_orbit_size(rhs_lhs);
+		if (multiplicity == 0) {
+			++result.stat.number_of_mirrored_diagrams;
+			return;
+		}
+	}
+	typename chord_like_type::in_place_type new_chord_diag(rhs_lhs);
+
+	// If an LP is skipped by the branch and bound, then its value is less than the threshold, and -1 is used instead.
+	// The threshold is the maximum found so far, or, if several worst diagrams are kept, the last of the worst diagrams of the current task.
+	// Such a diagram can get neither into the lists of the task nor into the merged lists.
+	const estimation_options& options = context.options;
+	bool use_bounds = options.use_branch_and_bound;
+	double values[2];
+	thread_local std::vector<double> solutions[2];
+	// The eliminations are traversed once for both cases. If the tree is large enough, it is shared with the idle threads of the pool.
+	std::shared_ptr<elimination_job<typename chord_like_type::in_place_type>> job;
+	if (result.pool != nullptr && result.pool->get_number_of_threads() > 1 && options.min_moves_to_share > 0 && length >= options.min_moves_to_share)
+		job = make_elimination_job<typename chord_like_type::in_place_type>(*result.pool, result.worker, length, options.min_moves_to_share, 
+			context.residual_cache, options.measure_stage_times);
+	all_linear_functions_for_both_cases(new_chord_diag, length, result.stat, options.measure_stage_times, context.residual_cache, job.get());
+	for (bool is_limit_case : { false, true }) {
+		double threshold = -1.;
+		if (use_bounds)
+			threshold = options.number_of_worst_diagrams > 1 ? result.estimate.get_worst_diagrams_threshold(is_limit_case)
+				: (is_limit_case ? context.best_value_limit : context.best_value_8).get();
+		values[is_limit_case] = get_estimate_for_functions(get_thread_function_front<typename chord_like_type::function_type>(is_limit_case), 
+			is_limit_case, result.stat, threshold, options.measure_stage_times, options.use_alglib_lp_solver, options.use_row_generation, 
+			options.number_of_worst_diagrams > 0 ? &solutions[is_limit_case] : nullptr);
+	}
+	result.estimate.add_diagram(rhs_lhs, values[0], values[1], multiplicity, &solutions[0], &solutions[1]);
+	// The estimates close to the maximum found so far are proved exactly. The maximum grows quickly, so only a small part of diagrams is certified.
+	if (options.certify_maximum)
+		for (bool is_limit_case : { false, true }) {
+			double value = values[is_limit_case], best_value = (is_limit_case ? context.best_value_limit : context.best_value_8).get();
+			long long numerator = 0, denominator = 0;
+			if (value >= 0. && value >= best_value - options.certification_tolerance * std::max(1., std::abs(best_value))
+				&& certify_estimate(get_thread_function_front<typename chord_like_type::function_type>(is_limit_case), is_limit_case, 
+					result.stat, numerator, denominator, options.measure_stage_times))
+				result.estimate.add_certified_estimate(rhs_lhs, is_limit_case, numerator, denominator);
+		}
+	if (!options.curve_sizes.empty()) {
+		thread_local std::vector<double> curve_size_values;
+		solve_for_curve_sizes(get_thread_function_front<typename chord_like_type::function_type>(false), options.curve_sizes, curve_size_values, 
+			result.stat, options.measure_stage_times);
+		result.estimate.add_curve_size_values(rhs_lhs, curve_size_values);
+	}
+	if (result.log != nullptr)
+		result.log->add(rhs_lhs, values[0], values[1], multiplicity);
+	if (use_bounds || options.certify_maximum) {
+		context.best_value_8.update(values[0]);
+		context.best_value_limit.update(values[1]);
+	}
+}
+
+// This function recursively traverses all possible interesting (pre)ACD starting with prefix by adding symbol new_v.
+// The prefix is checked and extended incrementally, see diagram_prefix.
+template<class chord_like_type>
+void walk_trough_all_diagrams(diagram_prefix& prefix, walk_result& result, int length, int new_v, walk_context& context) {
+	// Add new symbol.
+	prefix.push(new_v);
+	// Check if it can result in an interesting (pre)ACD
+	if (prefix.is_not_interesting()) {
+		++result.stat.number_of_pruned_prefixes;
+		prefix.pop();
+		return;
+	}
+	// Check that the size of rhs_lhs is sufficient to create the (pre)ACD.
+	if (prefix.size() == 2 * length) {
+		process_diagram<chord_like_type>(prefix.get_symbols(), result, length, context);
+		prefix.pop();
+		return;
+	}
+
+	for (unsigned values = prefix.get_possible_values(); values != 0; values &= values - 1)
+		walk_trough_all_diagrams<chord_like_type>(prefix, result, length, diagram_prefix::get_lowest_bit(values), context);
+	prefix.pop();
+}
+
+// Technical function. It recursively collects vectors rhs_lhs of the diagrams considered by walk_trough_all_diagrams (but not more than max_number of them).
 template<class chord_like_type>
-int calculate_estimate(int length, double& max_value_8, double& max_value_limit) {
-	// If tength is small, we do not use threads
+void collect_diagrams(diagram_prefix& prefix, std::vector<std::vector<int>>& diagrams, int length, size_t max_number, int new_v) {
+	if (diagrams.size() >= max_number)
+		return;
+	prefix.push(new_v);
+	if (!prefix.is_not_interesting()) {
+		if (prefix.size() == 2 * length)
+			diagrams.push_back(prefix.get_symbols());
+		else
+			for (unsigned values = prefix.get_possible_values(); values != 0; values &= values - 1)
+				collect_diagrams<chord_like_type>(prefix, diagrams, length, max_number, diagram_prefix::get_lowest_bit(values));
+	}
+	prefix.pop();
+}
+
+// Technical function. It returns the first max_number diagrams of the given length in the order of walk_trough_all_diagrams.
+template<class chord_like_type>
+std::vector<std::vector<int>> get_first_diagrams(int length, size_t max_number) {
+	std::vector<std::vector<int>> diagrams;
+	diagram_prefix prefix(length, chord_like_type::is_pre_ACD);
+	collect_diagrams<chord_like_type>(prefix, diagrams, length, max_number, 1);
+	return diagrams;
+}
+
+// Technical function. It recursively collects all interesting prefixes of the given size (or complete diagrams, if they are shorter).
+template<class chord_like_type>
+void collect_prefixes(diagram_prefix& prefix, std::vector<walk_task>& units, int length, int split_depth, int new_v) {
+	prefix.push(new_v);
+	if (prefix.is_not_interesting()) {
+		prefix.pop();
+		return;
+	}
+	if (prefix.size() == split_depth || prefix.size() == 2 * length) {
+		const std::vector<int>& rhs_lhs = prefix.get_symbols();
+		units.push_back(walk_task{ std::vector<int>(rhs_lhs.begin(), std::prev(rhs_lhs.end())), new_v, static_cast<int>(units.size()) });
+		prefix.pop();
+		return;
+	}
+	for (unsigned values = prefix.get_possible_values(); values != 0; values &= values - 1)
+		collect_prefixes<chord_like_type>(prefix, units, length, split_depth, diagram_prefix::get_lowest_bit(values));
+	prefix.pop();
+}
+
+// The tree of diagrams is divided into at least this number of units (if the length allows it).
+constexpr int min_number_of_units = 1024;
+
+// This function divides the tree of all (pre)ACD of the given length into units, i.e. the subtrees starting with all interesting prefixes of the same size.
+// The size is the smallest one giving at least min_number_of_units units, so the division depends only on the length.
+// Units are enumerated in the order of walk_trough_all_diagrams, and split_depth is set to the size of the prefixes.
+template<class chord_like_type>
+std::vector<walk_task> collect_units(int length, int& split_depth) {
+	std::vector<walk_task> units;
+	for (split_depth = 1; split_depth <= 2 * length; ++split_depth) {
+		diagram_prefix prefix(length, chord_like_type::is_pre_ACD);
+		units.clear();
+		collect_prefixes<chord_like_type>(prefix, units, length, split_depth, 1);
+		if (units.size() >= min_number_of_units)
+			break;
+	}
+	split_depth = std::min(split_depth, 2 * length);
+	return units;
+}
+
+// Technical function. It recursively adds to the corpus all interesting (pre)ACD starting with prefix followed by new_v.
+template<class chord_like_type>
+void export_diagrams(diagram_prefix& prefix, diagram_corpus_writer& writer, int length, int new_v) {
+	prefix.push(new_v);
+	if (!prefix.is_not_interesting()) {
+		if (prefix.size() == 2 * length)
+			writer.add(prefix.get_symbols());
+		else
+			for (unsigned values = prefix.get_possible_values(); values != 0; values &= values - 1)
+				export_diagrams<chord_like_type>(prefix, writer, length, diagram_prefix::get_lowest_bit(values));
+	}
+	prefix.pop();
+}
+
+// This function writes all interesting (pre)ACD of the given length to the corpus file (see diagram_corpus), unit by unit.
+// It returns the number of diagrams, or -1 if the file cannot be written.
+template<class chord_like_type>
+long long export_diagram_corpus(int length, const std::string& file_name) {
+	int split_depth = 0;
+	std::vector<walk_task> units = collect_units<chord_like_type>(length, split_depth);
+	diagram_corpus_writer writer(file_name, chord_like_type::is_pre_ACD ? 1 : 0, length, split_depth, static_cast<int>(units.size()));
+	for (const auto& unit : units) {
+		writer.start_unit();
+		diagram_prefix prefix(length, chord_like_type::is_pre_ACD, unit.rhs_lhs);
+		export_diagrams<chord_like_type>(prefix, writer, length, unit.new_v);
+	}
+	return writer.close() ? writer.get_number_of_diagrams() : -1;
+}
+
+// The same for a family of classes, e.g. export_diagram_corpus<ACD>(length, file_name).
+template<template<int> class diagram_family>
+long long export_diagram_corpus(int length, const std::string& file_name) {
+	auto function = [&](auto tag) { return export_diagram_corpus<typename decltype(tag)::type>(length, file_name); };
+	return length_dispatcher<diagram_family>::call(length, function);
+}
+
+// Ranges of the corpus with fewer records are never split.
+constexpr long long min_records_to_split = 64;
+
+// This function processes the records [first_record, end_record) of the corpus. If some thread of the pool is idle, the second half 
+// of the remaining records is given to the pool as a separate task of the same unit (if pool is null, nothing is split).
+template<class chord_like_type>
+void process_corpus_records(const diagram_corpus& corpus, work_stealing_pool<walk_task>* pool, enumeration_progress* progress, int worker, int unit,
+	long long first_record, long long end_record, walk_result& result, int length, walk_context& context) {
+	thread_local std::vector<int> rhs_lhs;
+	for (long long record = first_record; record < end_record; ++record) {
+		if (pool != nullptr && end_record - record >= 2 * min_records_to_split && pool->is_hungry()) {
+			long long middle = record + (end_record - record) / 2;
+			progress->add_task(unit);
+			walk_task task;
+			task.unit = unit;
+			task.first_record = middle;
+			task.end_record = end_record;
+			pool->push(worker, std::move(task));
+			end_record = middle;
+		}
+		corpus.get_diagram(record, rhs_lhs);
+		process_diagram<chord_like_type>(rhs_lhs, result, length, context);
+	}
+}
+
+// Subtrees with fewer remaining symbols are never split, since they are processed faster than they are stolen.
+constexpr int min_symbols_to_split = 4;
+
+// This function is the same as walk_trough_all_diagrams, but if some thread of the pool is idle, 
+// the subtree is split: all but the first possible continuations are given to the pool as separate tasks.
+// The new tasks belong to the same unit as the current one, and they are registered in progress.
+template<class chord_like_type>
+void walk_trough_all_diagrams_in_pool(work_stealing_pool<walk_task>& pool, enumeration_progress& progress, int worker, int unit, 
+	diagram_prefix& prefix, walk_result& result, int length, int new_v, walk_context& context) {
+	// Add new symbol.
+	prefix.push(new_v);
+	// Check if it can result in an interesting (pre)ACD
+	if (prefix.is_not_interesting()) {
+		++result.stat.number_of_pruned_prefixes;
+		prefix.pop();
+		return;
+	}
+	// Check that the size of rhs_lhs is sufficient to create the (pre)ACD.
+	if (prefix.size() == 2 * length) {
+		process_diagram<chord_like_type>(prefix.get_symbols(), result, length, context);
+		prefix.pop();
+		return;
+	}
+
+	unsigned possible_values = prefix.get_possible_values();
+	bool is_split = pool.is_hungry() && (2 * length - prefix.size() >= min_symbols_to_split);
+	for (unsigned values = possible_values; values != 0; values &= values - 1) {
+		int c = diagram_prefix::get_lowest_bit(values);
+		if (is_split && values != possible_values) {
+			progress.add_task(unit);
+			pool.push(worker, walk_task{ prefix.get_symbols(), c, unit });
+		}
+		else
+			walk_trough_all_diagrams_in_pool<chord_like_type>(pool, progress, worker, unit, prefix, result, length, c, context);
+	}
+	prefix.pop();
+}
+
+// Technical function. It returns true if the unit should be processed in the current run, see number_of_shards in estimation_options.
+// The units are dealt to the shards in turn, so that neighbouring (and thus similar) units go to different shards.
+// If shard_boundaries are given, the shard is the range of units between its boundaries instead.
+bool is_unit_in_shard(int unit, const estimation_options& options) noexcept {
+	if (options.number_of_shards <= 1)
+		return true;
+	if (static_cast<int>(options.shard_boundaries.size()) == options.number_of_shards + 1)
+		return options.shard_boundaries[options.shard_index] <= unit && unit < options.shard_boundaries[options.shard_index + 1];
+	return unit % options.number_of_shards == options.shard_index;
+}
+
+// This function traverses all (pre)ACD of the given length (or the part of them given by the shard in options) 
+// and returns the maximum estimates together with the diagrams giving them.
+// If stat is not null, the counters collected during the calculation are added to it.
+// If a checkpoint file is set in options, the completed units are periodically saved to it, and the calculation is resumed from it
+// (if it was written with the same settings, see estimation_options::get_fingerprint). The file is deleted when the calculation is completed.
+// If a corpus is set in options, the diagrams are read from it instead of being enumerated, with the same units.
+template<class chord_like_type>
+estimation_result find_worst_diagrams(int length, const estimation_options& options = estimation_options(), estimation_statistics* stat = nullptr) {
+	int number_of_threads = options.number_of_threads;
+	if (number_of_threads < 1)
+		number_of_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	walk_context context(options);
+
+	// The cache of the function sets of residual diagrams. It is saved at the end, so the sets found for this length are used by the next ones.
+	std::unique_ptr<function_set_cache> residual_cache;
+	std::string cache_file;
+	if (options.max_cached_residual_size > 0) {
+		residual_cache.reset(new function_set_cache(options.max_cached_residual_size));
+		if (!options.function_cache_prefix.empty()) {
+			cache_file = options.function_cache_prefix + "_" + get_class_name<chord_like_type>() + ".cache";
+			if (!residual_cache->load(cache_file))
+				std::clog << "The cache file " << cache_file << " has a wrong format or was written by another version, it is ignored" << std::endl;
+		}
+		context.residual_cache = residual_cache.get();
+	}
+	auto save_cache = [&residual_cache, &cache_file, stat]() {
+		if (residual_cache == nullptr)
+			return;
+		if (!cache_file.empty() && !residual_cache->save(cache_file))
+			std::clog << "The cache file " << cache_file << " cannot be written" << std::endl;
+		if (stat != nullptr) {
+			stat->number_of_residual_lookups += residual_cache->get_number_of_lookups();
+			stat->number_of_residual_hits += residual_cache->get_number_of_hits();
+		}
+	};
+
+	// The diagrams are read from the corpus instead of the enumeration, if it is given.
+	std::string file_name = get_class_name<chord_like_type>() + "_" + std::to_string(length);
+	diagram_corpus corpus;
+	if (!options.corpus_prefix.empty()) {
+		std::string corpus_file = options.corpus_prefix + "_" + file_name + ".corpus";
+		if (!corpus.open(corpus_file, chord_like_type::is_pre_ACD ? 1 : 0, length))
+			std::clog << "The corpus " << corpus_file << " cannot be read, the diagrams are enumerated" << std::endl;
+	}
+
+	// The files of the results log, one for every thread. All estimates are needed then, so the branch and bound is not used.
+	if (options.number_of_shards > 1)
+		file_name += "_shard" + std::to_string(options.shard_index) + "of" + std::to_string(options.number_of_shards);
+	std::vector<std::unique_ptr<results_log>> logs;
+	if (!options.results_log_prefix.empty()) {
+		context.options.use_branch_and_bound = false;
+		for (int i = 0; i < number_of_threads; ++i)
+			logs.emplace_back(new results_log(options.results_log_prefix + "_" + file_name + "_thread" + std::to_string(i) + ".log"));
+	}
+
+	// If tength is small, we do not use threads (the tree is not divided into shards either)
 	if (length < 6) {
-		std::vector<int> rhs_lhs({});
-		int number_of_diag = 0;
-		walk_trough_all_diagrams<chord_like_type>(rhs_lhs, max_value_8, max_value_limit, number_of_diag, length, 1);
-		return number_of_diag;
-	}
-
-	// Otherwise we use 11 threads.
-	constexpr int number_of_threads = 11;
-
-	std::thread calculation[number_of_threads];
-
-	int number_of_diag[number_of_threads];			// The number of diagrams traversed by each of the threads.
-	double estimate_8[number_of_threads],			// The maximum estimate obtained by each of the threads.
-		estimate_limit[number_of_threads];
-
-	std::fill_n(number_of_diag, number_of_threads, 0);
-	std::fill_n(estimate_8, number_of_threads, -1.);
-	std::fill_n(estimate_limit, number_of_threads, -1.);
-
-	// We have found that this partitioning results in the most uniform distribution of work between threads.
-	// Where lhs_rhs[i] is the starting lhs_rhs for the walk_trough_all_diagrams function, 
-	// and last_element[i] is the corresponding new_v symbol.
-	std::vector<int> lhs_rhs[number_of_threads];
-	lhs_rhs[0] = { 1, 2, 3, 4, 5 };
-	lhs_rhs[1] = { 1, 2, 3, 4, 5 };
-	lhs_rhs[2] = { 1, 2, 3, 4, 5 };
-	lhs_rhs[3] = { 1, 2, 3, 4, 5 };
-	lhs_rhs[4] = { 1, 2, 3, 4, 5 };
-	lhs_rhs[5] = { 1, 2, 3, 4 };
-	lhs_rhs[6] = { 1, 2, 3, 4 };
-	lhs_rhs[7] = { 1, 2, 3, 4 };
-	lhs_rhs[8] = { 1, 2, 3 };
-	lhs_rhs[9] = { 1, 2, 3 };
-	lhs_rhs[10] = { 1, 2};
-
-	int last_elements[number_of_threads] = { 6, 4, 3, 2, 1, 3, 2, 1, 2, 1, 1 };
-
-	for (int i = 0; i < number_of_threads; ++i) {
-		calculation[i] = std::thread(
-			walk_trough_all_diagrams<chord_like_type>,
-			std::ref(lhs_rhs[i]),
-			std::ref(estimate_8[i]),
-			std::ref(estimate_limit[i]),
-			std::ref(number_of_diag[i]),
-			length, last_elements[i]);
-	}
-
-	for (int i = 0; i < number_of_threads; ++i)
-		calculation[i].join();
-
-	// Merge the results of the work of the threads.
-	int total_num_of_diag = 0;
-	for (int i = 0; i < number_of_threads; ++i) {
-		max_value_8 = std::max(max_value_8, estimate_8[i]);
-		max_value_limit = std::max(max_value_limit, estimate_limit[i]);
-		total_num_of_diag += number_of_diag[i];
-	}
-	return total_num_of_diag;
+		walk_result result;
+		result.estimate.number_of_worst_diagrams = options.number_of_worst_diagrams;
+		result.estimate.curve_sizes = options.curve_sizes;
+		result.log = logs.empty() ? nullptr : logs[0].get();
+		if (options.number_of_shards <= 1 || options.shard_index == 0) {
+			stage_timer timer(options.measure_stage_times ? &result.stat.traversal_time : nullptr);
+			if (corpus.is_open())
+				process_corpus_records<chord_like_type>(corpus, nullptr, nullptr, 0, 0, 0, corpus.get_number_of_diagrams(), result, length, context);
+			else {
+				diagram_prefix prefix(length, chord_like_type::is_pre_ACD);
+				walk_trough_all_diagrams<chord_like_type>(prefix, result, length, 1, context);
+			}
+		}
+		if (stat != nullptr)
+			*stat += result.stat;
+		save_cache();
+		return result.estimate;
+	}
+
+	// Otherwise the tree is divided into units, which are given to the pool. A unit is split further as soon as some thread is idle.
+	// The units of the corpus are the same, so only their ranges of records are taken from its index.
+	int split_depth = 0;
+	std::vector<walk_task> units;
+	if (corpus.is_open()) {
+		split_depth = corpus.get_split_depth();
+		units.resize(corpus.get_number_of_units());
+		for (int i = 0; i < corpus.get_number_of_units(); ++i) {
+			units[i].unit = i;
+			units[i].first_record = corpus.get_unit_begin(i);
+			units[i].end_record = corpus.get_unit_begin(i + 1);
+		}
+	}
+	else
+		units = collect_units<chord_like_type>(length, split_depth);
+	std::string checkpoint_file;
+	if (!options.checkpoint_prefix.empty())
+		checkpoint_file = options.checkpoint_prefix + "_" + file_name + ".ckpt";
+	enumeration_progress progress(checkpoint_file, chord_like_type::is_pre_ACD ? 1 : 0, length, split_depth, 
+		static_cast<int>(units.size()), options.checkpoint_interval, context.options.get_fingerprint());
+	if (progress.load()) {
+		// The maximums of the completed units are used as the initial values for the branch and bound.
+		estimation_result completed = progress.get_total();
+		context.best_value_8.update(completed.value_8);
+		context.best_value_limit.update(completed.value_limit);
+	}
+
+	work_stealing_pool<walk_task> pool(number_of_threads);
+	for (auto& unit : units) {
+		if (!is_unit_in_shard(unit.unit, options) || progress.is_completed(unit.unit))
+			continue;
+		progress.add_task(unit.unit);
+		pool.push(unit.unit, std::move(unit));
+	}
+
+	// The progress is reported by a separate thread. The remaining time is estimated by the units completed in this run.
+	int number_of_loaded_units = progress.get_number_of_completed_units(), number_of_units = static_cast<int>(units.size());
+	std::string class_name = get_class_name<chord_like_type>();
+	periodic_reporter reporter([&progress, &context, &class_name, length, number_of_loaded_units, number_of_units](double time) {
+		int completed_units = progress.get_number_of_completed_units();
+		std::stringstream stream;
+		stream << class_name << " of length " << length << ": " << completed_units << " of " << number_of_units << " units completed, "
+			<< context.number_of_diagrams.load(std::memory_order_relaxed) << " diagrams processed, " << get_time(time) << " passed";
+		if (completed_units > number_of_loaded_units)
+			stream << ", about " << get_time(time * (number_of_units - completed_units) / (completed_units - number_of_loaded_units)) << " left";
+		std::clog << stream.str() << std::endl;
+	}, options.progress_interval);
+
+	std::vector<walk_result> results(number_of_threads);
+	pool.run([&results, &progress, &pool, &context, &options, &logs, &corpus, length](int worker, walk_task& task) {
+		if (task.shared_states) {
+			stage_timer timer(options.measure_stage_times ? &results[worker].stat.traversal_time : nullptr);
+			task.shared_states(results[worker].stat);
+			return;
+		}
+		walk_result task_result;
+		task_result.estimate.number_of_worst_diagrams = options.number_of_worst_diagrams;
+		task_result.estimate.curve_sizes = options.curve_sizes;
+		task_result.log = logs.empty() ? nullptr : logs[worker].get();
+		task_result.pool = &pool;
+		task_result.worker = worker;
+		{
+			stage_timer timer(options.measure_stage_times ? &task_result.stat.traversal_time : nullptr);
+			if (corpus.is_open())
+				process_corpus_records<chord_like_type>(corpus, &pool, &progress, worker, task.unit, task.first_record, task.end_record, 
+					task_result, length, context);
+			else {
+				diagram_prefix prefix(length, chord_like_type::is_pre_ACD, task.rhs_lhs);
+				walk_trough_all_diagrams_in_pool<chord_like_type>(pool, progress, worker, task.unit, prefix, task_result, length, task.new_v, context);
+			}
+		}
+		results[worker].stat += task_result.stat;
+		progress.finish_task(task.unit, task_result.estimate);
+	});
+
+	if (stat != nullptr)
+		for (const auto& result : results)
+			*stat += result.stat;
+	save_cache();
+	// Merge the results of all units. All units of the shard are completed, so the checkpoint is not needed any more.
+	estimation_result total = progress.get_total();
+	progress.remove();
+	return total;
+}
+
+// The same for a family of classes, e.g. find_worst_diagrams<ACD>(length): the class of the exact length is chosen, see length_dispatcher.
+template<template<int> class diagram_family>
+estimation_result find_worst_diagrams(int length, const estimation_options& options = estimation_options(), estimation_statistics* stat = nullptr) {
+	auto function = [&](auto tag) { return find_worst_diagrams<typename decltype(tag)::type>(length, options, stat); };
+	return length_dispatcher<diagram_family>::call(length, function);
+}
+
+// This is the main function for finding estimates. It returns the total number of traversed (pre)ACD.
+// See find_worst_diagrams for details.
+template<template<int> class diagram_family>
+long long calculate_estimate(int length, double& max_value_8, double& max_value_limit, const estimation_options& options = estimation_options(), estimation_statistics* stat = nullptr) {
+	estimation_result result = find_worst_diagrams<diagram_family>(length, options, stat);
+	max_value_8 = std::max(max_value_8, result.value_8);
+	max_value_limit = std::max(max_value_limit, result.value_limit);
+	return result.number_of_diag;
+}
+
+// This function checks the symmetry reduction: all (pre)ACD of the given length are traversed with and without it, 
+// and the function returns true if the numbers of diagrams coincide and the maximum estimates agree up to the rounding errors of the LP.
+template<template<int> class diagram_family>
+bool verify_symmetry_reduction(int length, estimation_options options = estimation_options()) {
+	options.checkpoint_prefix.clear();
+	options.use_symmetry_reduction = false;
+	estimation_result full = find_worst_diagrams<diagram_family>(length, options);
+	options.use_symmetry_reduction = true;
+	estimation_result reduced = find_worst_diagrams<diagram_family>(length, options);
+
+	constexpr double eps = 1e-9;
+	return full.number_of_diag == reduced.number_of_diag
+		&& std::abs(full.value_8 - reduced.value_8) <= eps * std::max(1., std::abs(full.value_8))
+		&& std::abs(full.value_limit - reduced.value_limit) <= eps * std::max(1., std::abs(full.value_limit));
+}
+
+// This function checks the classes with transformations applied in place (ACD_in_place and pre_ACD_in_place) against the reference classes:
+// for the first max_number_of_diagrams diagrams of the given length, both cases (m = 8 and the limit case) must give the same functions 
+// in the same order, and the diagram must be restored after the traversal. It returns true if all the results coincide.
+template<class chord_like_type>
+bool verify_in_place_elimination(int length, size_t max_number_of_diagrams) {
+	using in_place_type = typename chord_like_type::in_place_type;
+	for (const auto& rhs_lhs : get_first_diagrams<chord_like_type>(length, max_number_of_diagrams)) {
+		in_place_type diagram(rhs_lhs);
+		std::vector<int> initial_key, final_key, state_key;
+		diagram.get_state_key(initial_key);
+		for (bool is_limit_case : { false, true }) {
+			linear_function_front<typename chord_like_type::function_type> reference_results, results;
+			transposition_table reference_states, states;
+			all_linear_functions_chord_diagram(chord_like_type(rhs_lhs), reference_results, length, is_limit_case, reference_states);
+			all_linear_functions_in_place(diagram, results, length, is_limit_case, states, state_key);
+			if (results.size() != reference_results.size() || !std::equal(results.begin(), results.end(), reference_results.begin())
+				|| results.get_number_of_offered_functions() != reference_results.get_number_of_offered_functions())
+				return false;
+			diagram.get_state_key(final_key);
+			if (final_key != initial_key)
+				return false;
+		}
+	}
+	return true;
+}
+
+// The same for a family of classes, e.g. verify_in_place_elimination<ACD>(length, 1000).
+template<template<int> class diagram_family>
+bool verify_in_place_elimination(int length, size_t max_number_of_diagrams) {
+	auto function = [&](auto tag) { return verify_in_place_elimination<typename decltype(tag)::type>(length, max_number_of_diagrams); };
+	return length_dispatcher<diagram_family>::call(length, function);
+}
+
+// Technical function. It writes the lists of the worst diagrams (see number_of_worst_diagrams in estimation_options) into the stream.
+// The values are written in the same way as in make_simple_output.
+void write_worst_diagrams(std::ostream& stream_out, const estimation_result& result) {
+	for (bool is_limit_case : { false, true }) {
+		const auto& worst_diagrams = is_limit_case ? result.worst_diagrams_limit : result.worst_diagrams_8;
+		if (worst_diagrams.empty())
+			continue;
+		stream_out << (is_limit_case ? "The worst diagrams in the limit case:\n" : "The worst diagrams for m = 8:\n");
+		for (const auto& estimate : worst_diagrams) {
+			stream_out << std::fixed << std::setprecision(8) << "  " << (is_limit_case ? estimate.value + 1. : estimate.value / 8. + 1.) << ", diagram";
+			for (int c : estimate.diagram)
+				stream_out << " " << c;
+			stream_out << ", solution" << std::setprecision(4);
+			for (double x : estimate.solution)
+				stream_out << " " << x;
+			stream_out << "\n";
+		}
+	}
+}
+
+// Technical function. It writes the maximum estimates for the sizes of the starting curve (see curve_sizes in estimation_options) into the stream.
+// The values are written as for m = 8 in make_simple_output, i.e. the value for m is divided by m and increased by 1.
+void write_curve_size_values(std::ostream& stream_out, const estimation_result& result) {
+	if (result.curve_size_values.empty())
+		return;
+	stream_out << "The worst values for the sizes of the starting curve:\n";
+	for (size_t i = 0; i < result.curve_size_values.size(); ++i) {
+		stream_out << "  m = " << std::defaultfloat << result.curve_sizes[i] << ": " << std::fixed << std::setprecision(8) 
+			<< result.curve_size_values[i] / result.curve_sizes[i] + 1. << ", diagram";
+		for (int c : result.curve_size_worst_diagrams[i])
+			stream_out << " " << c;
+		stream_out << "\n";
+	}
+}
+
+// Technical function. It writes the certified estimate in the same way as make_simple_output, i.e. numerator / denominator / 8 + 1 for m = 8
+// and numerator / denominator + 1 in the limit case, as an irreducible fraction. If nothing is certified, it writes "none".
+void write_certified_fraction(std::ostream& stream_out, const certified_estimate& estimate, bool is_limit_case) {
+	if (!estimate.is_certified()) {
+		stream_out << "none";
+		return;
+	}
+	long long scale = is_limit_case ? 1 : 8;
+	long long numerator = estimate.numerator + scale * estimate.denominator, denominator = scale * estimate.denominator;
+	long long divisor = std::abs(numerator), remainder = denominator;
+	while (remainder != 0) {
+		long long next = divisor % remainder;
+		divisor = remainder;
+		remainder = next;
+	}
+	stream_out << numerator / divisor << "/" << denominator / divisor;
+}
+
+// Technical function. It writes the certified maximum estimates (see certify_maximum in estimation_options) and the diagrams giving them into the stream.
+// The certified maximum should be the floating-point one up to the rounding errors, otherwise the difference is reported.
+void write_certified_values(std::ostream& stream_out, const estimation_result& result, double tolerance) {
+	for (bool is_limit_case : { false, true }) {
+		const certified_estimate& estimate = is_limit_case ? result.certified_limit : result.certified_8;
+		double value = is_limit_case ? result.value_limit : result.value_8;
+		stream_out << (is_limit_case ? "The certified worst value in the limit case: " : "The certified worst value for m = 8: ");
+		write_certified_fraction(stream_out, estimate, is_limit_case);
+		if (!estimate.is_certified()) {
+			stream_out << "\n";
+			continue;
+		}
+		double certified_value = estimate.get_value();
+		stream_out << std::fixed << std::setprecision(8) << " = " << (is_limit_case ? certified_value + 1. : certified_value / 8. + 1.) << ", diagram";
+		for (int c : estimate.diagram)
+			stream_out << " " << c;
+		if (std::abs(certified_value - value) > tolerance * std::max(1., std::abs(value)))
+			stream_out << ", it differs from the floating-point maximum by " << std::scientific << certified_value - value;
+		stream_out << "\n";
+	}
+}
+
+// Technical function. It finds the estimates of the given length for a family of classes, prints them to std::cout and file_out, 
+// and adds a JSON object with the results and the statistics to json_entries.
+// The time in the output is the wall-clock time, and the CPU time of the process (i.e. the sum over all threads) is printed with the statistics.
+template<template<int> class diagram_family>
+void find_and_write_estimates(std::ostream& file_out, int length, const estimation_options& options, std::vector<std::string>& json_entries) {
+	auto start = std::chrono::steady_clock::now();
+	std::clock_t cpu_start = std::clock();
+	estimation_statistics stat;
+	estimation_result result = find_worst_diagrams<diagram_family>(length, options, &stat);
+	long long num_of_diag = result.number_of_diag;
+	double max_value_8 = result.value_8,
+		max_value_limit = result.value_limit;
+	double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double cpu_time = (double)(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+	make_simple_output<diagram_family>(std::cout, length, num_of_diag, max_value_8, max_value_limit, wall_time);
+	std::cout << stat << ". CPU time of the process: " << get_time(cpu_time) << std::endl;
+	make_simple_output<diagram_family>(file_out, length, num_of_diag, max_value_8, max_value_limit, wall_time);
+	write_worst_diagrams(std::cout, result);
+	write_curve_size_values(std::cout, result);
+	if (options.certify_maximum)
+		write_certified_values(std::cout, result, options.certification_tolerance);
+
+	std::stringstream entry;
+	entry << std::setprecision(17)
+		<< "{\"class\": \"" << get_class_name<diagram_family>() << "\", \"length\": " << length << ", \"diagrams\": " << num_of_diag
+		<< ", \"value_8\": " << max_value_8 / 8. + 1. << ", \"value_limit\": " << max_value_limit + 1.
+		<< ", \"wall_time\": " << wall_time << ", \"cpu_time\": " << cpu_time;
+	for (bool is_limit_case : { false, true }) {
+		entry << (is_limit_case ? ", \"worst_diagrams_limit\": [" : ", \"worst_diagrams_8\": [");
+		const auto& worst_diagrams = is_limit_case ? result.worst_diagrams_limit : result.worst_diagrams_8;
+		for (size_t i = 0; i < worst_diagrams.size(); ++i) {
+			entry << (i == 0 ? "" : ", ") << "{\"value\": " << worst_diagrams[i].value << ", \"diagram\": [";
+			for (size_t j = 0; j < worst_diagrams[i].diagram.size(); ++j)
+				entry << (j == 0 ? "" : ", ") << worst_diagrams[i].diagram[j];
+			entry << "], \"solution\": [";
+			for (size_t j = 0; j < worst_diagrams[i].solution.size(); ++j)
+				entry << (j == 0 ? "" : ", ") << worst_diagrams[i].solution[j];
+			entry << "]}";
+		}
+		entry << "]";
+	}
+	entry << ", \"curve_sizes\": [";
+	for (size_t i = 0; i < result.curve_size_values.size(); ++i) {
+		entry << (i == 0 ? "" : ", ") << "{\"m\": " << result.curve_sizes[i] << ", \"value\": " << result.curve_size_values[i] / result.curve_sizes[i] + 1. 
+			<< ", \"diagram\": [";
+		for (size_t j = 0; j < result.curve_size_worst_diagrams[i].size(); ++j)
+			entry << (j == 0 ? "" : ", ") << result.curve_size_worst_diagrams[i][j];
+		entry << "]}";
+	}
+	entry << "]";
+	for (bool is_limit_case : { false, true }) {
+		const certified_estimate& estimate = is_limit_case ? result.certified_limit : result.certified_8;
+		entry << (is_limit_case ? ", \"certified_value_limit\": " : ", \"certified_value_8\": ");
+		if (!estimate.is_certified()) {
+			entry << "null";
+			continue;
+		}
+		entry << "{\"fraction\": \"";
+		write_certified_fraction(entry, estimate, is_limit_case);
+		entry << "\", \"value\": " << (is_limit_case ? estimate.get_value() + 1. : estimate.get_value() / 8. + 1.) << ", \"diagram\": [";
+		for (size_t j = 0; j < estimate.diagram.size(); ++j)
+			entry << (j == 0 ? "" : ", ") << estimate.diagram[j];
+		entry << "]}";
+	}
+	entry << ", \"statistics\": ";
+	stat.write_json(entry);
+	entry << "}";
+	json_entries.push_back(entry.str());
 }
 
 // This function finds all the estimates, print them and saves the results to files. 
-void get_main_estimates(std::ofstream& file_out_ACD, std::ofstream& file_out_pre_ACD, int start_length = 1, int max_length = 6) {	
+// The settings of the calculation (e.g. the number of threads and checkpoints) are given in options.
+// If the statistics file is set in options, it is rewritten after every length, so it contains the completed lengths if the run is interrupted.
+void get_main_estimates(std::ofstream& file_out_ACD, std::ofstream& file_out_pre_ACD, int start_length = 1, int max_length = 6, 
+	const estimation_options& options = estimation_options()) {	
+	std::vector<std::string> json_entries;
 	for (int k = start_length; k <= max_length; ++k) {
 		std::cout
 			<< "##################\n"
 			<< "      Size " << k
 			<< "\n##################\n";
 
-		// Find estimates for preACD.
-		std::clock_t start = std::clock();
-		double max_value_8 = -1,
-			max_value_limit = -1;
-		int num_of_diag = calculate_estimate<pre_ACD>(k, max_value_8, max_value_limit);
-		
-		make_simple_output<pre_ACD>(std::cout, k, num_of_diag, max_value_8, max_value_limit, start);
-		make_simple_output<pre_ACD>(file_out_pre_ACD, k, num_of_diag, max_value_8, max_value_limit, start);
-
-		// Find estimates for ACD.
-		start = std::clock();
-		max_value_8 = -1;
-		max_value_limit = -1;
+		// Find estimates for preACD and ACD.
+		find_and_write_estimates<pre_ACD>(file_out_pre_ACD, k, options, json_entries);
+		find_and_write_estimates<ACD>(file_out_ACD, k, options, json_entries);
 
-		num_of_diag = calculate_estimate<ACD>(k, max_value_8, max_value_limit);
-
-		make_simple_output<ACD>(std::cout, k, num_of_diag, max_value_8, max_value_limit, start);
-		make_simple_output<ACD>(file_out_ACD, k, num_of_diag, max_value_8, max_value_limit, start);
+		if (!options.statistics_file.empty()) {
+			std::ofstream statistics_out(options.statistics_file, std::ios::trunc);
+			statistics_out << "[";
+			for (size_t i = 0; i < json_entries.size(); ++i)
+				statistics_out << (i == 0 ? "\n  " : ",\n  ") << json_entries[i];
+			statistics_out << "\n]\n";
+		}
 	}
 }
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include "brute_force_functions.h"
 
 int main() {
-	std::cout << "Write number of chords (it should be less than " << n_max << "): "; // See linear_function_coefficients for details.
+	std::cout << "Write number of chords (it should be less than " << n_max << "): "; // See chord_diagram_base_class.h for details.
 	int n = 1;
 	std::cin >> n;
 
@@ -16,6 +16,23 @@ int main() {
 	std::ofstream file_out_ACD("Files with numbers//the_output_1-" + std::to_string(n) + "(ACD).txt");
 	std::ofstream file_out_pre_ACD("Files with numbers//the_output_1-" + std::to_string(n) + "(pre_ACD).txt");
 
-	get_main_estimates(file_out_ACD, file_out_pre_ACD, 1, n);
+	// The progress is saved to checkpoint files, so an interrupted run resumes from the last checkpoint.
+	estimation_options options;
+	options.checkpoint_prefix = "checkpoint";
+	// Mirror images of diagrams give the same estimates, so only one of them is solved.
+	options.use_symmetry_reduction = true;
+	// An LP is skipped if its upper bound shows that it cannot change the maximum.
+	options.use_branch_and_bound = true;
+	// The progress is printed every minute, and the statistics of all lengths are saved in JSON format.
+	options.progress_interval = 60.;
+	options.measure_stage_times = true;
+	options.statistics_file = "Files with numbers//statistics_1-" + std::to_string(n) + ".json";
+	// The ten worst diagrams of every length are printed together with the optimal points of their LPs.
+	options.number_of_worst_diagrams = 10;
+	// The sets of functions of small residual diagrams are reused by all diagrams, and they are saved for the next runs.
+	options.max_cached_residual_size = 10;
+	options.function_cache_prefix = "functions";
+
+	get_main_estimates(file_out_ACD, file_out_pre_ACD, 1, n, options);
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "brute_force_functions.h"
+#include "Technical classes/workload_plan.h"
+
+/*
+This file contains functions for planning a calculation before it is started, e.g. for choosing the number of machines for a new length.
+The size of the tree of diagrams and the cost of its leaves are estimated by random descents (Knuth's estimator): a descent chooses
+a random interesting continuation at every level, and the product of the numbers of continuations along the path is an unbiased estimate
+of the number of leaves of the subtree. The estimate multiplied by the measured time of the leaf is an unbiased estimate of the time of the subtree.
+Every unit of the tree (see collect_units) is sampled separately, so the units can also be divided into parts of equal predicted cost.
+*/
+
+// Technical function. It makes one random descent from the prefix of the unit followed by new_v to a complete diagram, which is written to rhs_lhs.
+// It returns the product of the numbers of interesting continuations along the path, or 0 if the path ends in a prefix without them.
+template<class chord_like_type>
+double make_random_descent(const walk_task& unit, int length, std::mt19937_64& generator, std::vector<int>& rhs_lhs) {
+	diagram_prefix prefix(length, chord_like_type::is_pre_ACD, unit.rhs_lhs);
+	prefix.push(unit.new_v);
+	double weight = 1.;
+	int continuations[diagram_prefix::max_symbol + 1];
+	while (prefix.size() < 2 * length) {
+		int number_of_continuations = 0;
+		for (unsigned values = prefix.get_possible_values(); values != 0; values &= values - 1) {
+			int c = diagram_prefix::get_lowest_bit(values);
+			prefix.push(c);
+			if (!prefix.is_not_interesting())
+				continuations[number_of_continuations++] = c;
+			prefix.pop();
+		}
+		if (number_of_continuations == 0)
+			return 0.;
+		weight *= number_of_continuations;
+		prefix.push(continuations[std::uniform_int_distribution<int>(0, number_of_continuations - 1)(generator)]);
+	}
+	rhs_lhs = prefix.get_symbols();
+	return weight;
+}
+
+// Technical function. It returns the memory used by the containers of the current thread for the last diagram, in bytes: 
+// the transposition table, the sets of functions of both cases and the matrix of the larger LP (see max_min_solver).
+template<class function_type>
+double get_thread_memory_usage() {
+	const auto& functions_8 = get_thread_function_front<function_type>(false);
+	const auto& functions_limit = get_thread_function_front<function_type>(true);
+	size_t number_of_columns = functions_8.empty() ? 0 : functions_8.cbegin()->get_number_of_variables();
+	return static_cast<double>(get_thread_transposition_table().get_memory_usage() + (functions_8.size() + functions_limit.size()) * sizeof(function_type)
+		+ std::max(functions_8.size(), functions_limit.size()) * number_of_columns * sizeof(double));
+}
+
+// This function predicts the number of diagrams, the CPU time and the memory of the calculation of the given length with the given options
+// (the cache of residual diagrams and the checkpoints are not used) by descents_per_unit random descents in every unit. The diagram at the end
+// of every descent is processed as in find_worst_diagrams, and its time is measured. The units are divided into number_of_parts parts of equal
+// predicted cost. The descents are random, but they depend only on the seed.
+template<class chord_like_type>
+workload_plan plan_workload(int length, int number_of_parts, estimation_options options = estimation_options(), int descents_per_unit = 16,
+	unsigned seed = 1) {
+	auto start = std::chrono::steady_clock::now();
+	options.max_cached_residual_size = 0;
+	options.results_log_prefix.clear();
+	options.curve_sizes.clear();
+	walk_context context(options);
+	walk_result result;
+	std::mt19937_64 generator(seed);
+
+	workload_plan plan;
+	plan.class_name = get_class_name<chord_like_type>();
+	plan.length = length;
+	std::vector<walk_task> units = collect_units<chord_like_type>(length, plan.split_depth);
+	plan.unit_costs.assign(units.size(), 0.);
+	double variance_of_diagrams = 0., variance_of_time = 0.;
+	std::vector<int> rhs_lhs;
+	for (size_t u = 0; u < units.size(); ++u) {
+		// The means and the variances of the estimates of the number of diagrams and of the time of the unit.
+		double sum_of_diagrams = 0., sum_of_squared_diagrams = 0., sum_of_times = 0., sum_of_squared_times = 0.;
+		for (int i = 0; i < descents_per_unit; ++i) {
+			double weight = make_random_descent<chord_like_type>(units[u], length, generator, rhs_lhs), time = 0.;
+			if (weight > 0.) {
+				auto diagram_start = std::chrono::steady_clock::now();
+				process_diagram<chord_like_type>(rhs_lhs, result, length, context);
+				time = weight * std::chrono::duration<double>(std::chrono::steady_clock::now() - diagram_start).count();
+				plan.memory_per_thread = std::max(plan.memory_per_thread, get_thread_memory_usage<typename chord_like_type::function_type>());
+			}
+			sum_of_diagrams += weight;
+			sum_of_squared_diagrams += weight * weight;
+			sum_of_times += time;
+			sum_of_squared_times += time * time;
+		}
+		double n = descents_per_unit;
+		plan.number_of_diagrams += sum_of_diagrams / n;
+		plan.unit_costs[u] = sum_of_times / n;
+		plan.cpu_time += plan.unit_costs[u];
+		if (descents_per_unit > 1) {
+			variance_of_diagrams += std::max(0., sum_of_squared_diagrams - sum_of_diagrams * sum_of_diagrams / n) / (n - 1) / n;
+			variance_of_time += std::max(0., sum_of_squared_times - sum_of_times * sum_of_times / n) / (n - 1) / n;
+		}
+	}
+	plan.number_of_descents = static_cast<long long>(units.size()) * descents_per_unit;
+	plan.number_of_diagrams_error = std::sqrt(variance_of_diagrams);
+	plan.cpu_time_error = std::sqrt(variance_of_time);
+
+	// The part p ends at the first unit where the predicted cost of the units before it reaches p / number_of_parts of the total cost.
+	// Every part gets at least one unit if there are enough of them.
+	int number_of_units = static_cast<int>(units.size());
+	number_of_parts = std::max(1, number_of_parts);
+	plan.part_boundaries.assign(1, 0);
+	double cost = 0.;
+	int unit = 0;
+	for (int p = 1; p < number_of_parts; ++p) {
+		double target = plan.cpu_time * p / number_of_parts;
+		while (unit < number_of_units - (number_of_parts - p) && (unit < plan.part_boundaries.back() + 1 || cost + plan.unit_costs[unit] / 2. < target))
+			cost += plan.unit_costs[unit++];
+		plan.part_boundaries.push_back(unit);
+	}
+	plan.part_boundaries.push_back(number_of_units);
+	for (int p = 0; p < number_of_parts; ++p) {
+		plan.part_costs.push_back(0.);
+		for (int u = plan.part_boundaries[p]; u < plan.part_boundaries[p + 1]; ++u)
+			plan.part_costs.back() += plan.unit_costs[u];
+		std::vector<int> prefix;
+		if (plan.part_boundaries[p] < number_of_units) {
+			prefix = units[plan.part_boundaries[p]].rhs_lhs;
+			prefix.push_back(units[plan.part_boundaries[p]].new_v);
+		}
+		plan.part_prefixes.push_back(prefix);
+	}
+	plan.sampling_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return plan;
+}
+
+// The same for a family of classes, e.g. plan_workload<pre_ACD>(10, 16): the class of the exact length is chosen, see length_dispatcher.
+template<template<int> class diagram_family>
+workload_plan plan_workload(int length, int number_of_parts, const estimation_options& options = estimation_options(), int descents_per_unit = 16,
+	unsigned seed = 1) {
+	auto function = [&](auto tag) { return plan_workload<typename decltype(tag)::type>(length, number_of_parts, options, descents_per_unit, seed); };
+	return length_dispatcher<diagram_family>::call(length, function);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Technical classes/estimation_result.h"
+#include "Technical classes/results_log.h"
+
+/*
+This file contains functions for the analysis of the results logs written during the calculation (see results_log_prefix in estimation_options).
+They read the estimates of all diagrams from the files, so the questions about the distribution of the estimates do not require a new calculation.
+*/
+
+// This function reads the results logs (e.g. the files of all threads of one length) and returns the same results as find_worst_diagrams:
+// the maximum estimates, the number of diagrams and the lists of number_of_worst_diagrams worst diagrams (without the optimal points of the LPs).
+// It returns false if some file cannot be read.
+bool scan_results_logs(const std::vector<std::string>& file_names, int number_of_worst_diagrams, estimation_result& result) {
+	result = estimation_result();
+	result.number_of_worst_diagrams = number_of_worst_diagrams;
+	std::vector<results_log::record> records;
+	for (const auto& file_name : file_names) {
+		records.clear();
+		if (!results_log::read(file_name, records))
+			return false;
+		for (const auto& record : records)
+			result.add_diagram(record.get_diagram(), record.value_8, record.value_limit, record.multiplicity);
+	}
+	return true;
+}
+
+// This function reads the results logs and returns the numbers of diagrams whose estimates (as written by make_simple_output, i.e. value_8 / 8 + 1
+// and value_limit + 1) fall into the intervals [k * step, (k + 1) * step), so histogram[is_limit_case][k] is the number of diagrams in the k-th interval.
+// It returns false if some file cannot be read.
+bool get_histogram_of_estimates(const std::vector<std::string>& file_names, double step, std::vector<long long> histogram[2]) {
+	histogram[0].clear();
+	histogram[1].clear();
+	std::vector<results_log::record> records;
+	for (const auto& file_name : file_names) {
+		records.clear();
+		if (!results_log::read(file_name, records))
+			return false;
+		for (const auto& record : records) {
+			double values[2] = { record.value_8 / 8. + 1., record.value_limit + 1. };
+			for (int i = 0; i < 2; ++i) {
+				size_t k = static_cast<size_t>(values[i] / step);
+				if (histogram[i].size() <= k)
+					histogram[i].resize(k + 1, 0);
+				histogram[i][k] += record.multiplicity;
+			}
+		}
+	}
+	return true;
+}
\ No newline at end of file
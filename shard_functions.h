@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "brute_force_functions.h"
+#include "Technical classes/shard_result.h"
+
+/*
+This file contains functions for dividing the calculation for one length between several independent processes (e.g. on different machines).
+Every process runs run_shard with its own shard_index and the same number_of_shards, and writes a small file with its results.
+Then merge_shard_files combines these files and writes the same line as get_main_estimates.
+*/
+
+// This function processes the units of the shard given in options and writes the results to the file. 
+// It returns false if the file cannot be written.
+template<template<int> class diagram_family>
+bool run_shard(int length, const estimation_options& options, const std::string& file_name, estimation_statistics* stat = nullptr) {
+	auto start = std::chrono::steady_clock::now();
+	std::clock_t cpu_start = std::clock();
+	shard_result shard;
+	shard.class_name = get_class_name<diagram_family>();
+	shard.length = length;
+	shard.shard_index = options.number_of_shards > 1 ? options.shard_index : 0;
+	shard.number_of_shards = std::max(1, options.number_of_shards);
+	if (shard.number_of_shards > 1 && static_cast<int>(options.shard_boundaries.size()) == shard.number_of_shards + 1)
+		shard.shard_boundaries = options.shard_boundaries;
+	estimation_options shard_options = options;
+	shard_options.shard_index = 0;
+	shard.fingerprint = shard_options.get_fingerprint();
+	shard.result = find_worst_diagrams<diagram_family>(length, options, stat);
+	shard.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	shard.cpu_time = (double)(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+	std::ofstream file_out(file_name);
+	file_out << shard;
+	return static_cast<bool>(file_out);
+}
+
+// This function reads the files written by run_shard for all shards of the same length and writes the combined results into the stream.
+// The time in the output is the sum of the wall-clock times of all shards, as if they were run one after another in one process.
+// It returns false (and writes nothing) if some file cannot be read, if the files belong to different calculations
+// (including different partitions of the units into shards and different settings, see get_fingerprint), or if some shard is missing.
+template<template<int> class diagram_family>
+bool merge_shard_files(const std::vector<std::string>& file_names, std::ostream& stream_out, estimation_result* merged_result = nullptr) {
+	std::vector<shard_result> shards(file_names.size());
+	for (size_t i = 0; i < file_names.size(); ++i) {
+		std::ifstream file_in(file_names[i]);
+		if (!(file_in >> shards[i]))
+			return false;
+	}
+	if (shards.empty())
+		return false;
+
+	int number_of_shards = shards[0].number_of_shards;
+	std::vector<bool> is_present(number_of_shards, false);
+	estimation_result result;
+	double time = 0.;
+	for (const auto& shard : shards) {
+		if (shard.class_name != get_class_name<diagram_family>() || shard.length != shards[0].length || shard.number_of_shards != number_of_shards
+			|| shard.shard_boundaries != shards[0].shard_boundaries || shard.fingerprint != shards[0].fingerprint
+			|| shard.shard_index < 0 || shard.shard_index >= number_of_shards || is_present[shard.shard_index])
+			return false;
+		is_present[shard.shard_index] = true;
+		result += shard.result;
+		time += shard.time;
+	}
+	if (std::find(is_present.begin(), is_present.end(), false) != is_present.end())
+		return false;
+
+	make_simple_output<diagram_family>(stream_out, shards[0].length, result.number_of_diag, result.value_8, result.value_limit, time);
+	if (merged_result != nullptr)
+		*merged_result = result;
+	return true;
+}
\ No newline at end of file